@@ -2,17 +2,29 @@
 #include <Loggers/AbstractLogger.hpp>
 #include <memory>
 #include <Stream.hpp>
+#include <CurrentLogger.hpp>
 #include <cstring>
 #include <Loggers/BasicLogger.hpp>
 #include <Loggers/AsyncLogger.hpp>
+#include <Loggers/StaticLogger.hpp>
+#include <Backtrace.hpp>
+#include <TraceSpan.hpp>
+#include <Sinks/MappedFileSink.hpp>
+#include <Sinks/UringFileSink.hpp>
+#include <Sinks/FileSink.hpp>
+#include <Formatters/PatternFormatter.hpp>
+#include <Formatters/Sanitizer.hpp>
+#include <Clock.hpp>
+#include <BoundedQueue.hpp>
+#include <RecordQueue.hpp>
 #include <iostream>
 #include "IostreamsLock.hpp"
 #include "Utilities.hpp"
 
-#define DebugF(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define InfoF(L)     Loggers::Stream(L, AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define WarningF(L)  Loggers::Stream(L, AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define ErrorF(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define DebugL(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define InfoL(L)     Loggers::Stream(L, AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define WarningL(L)  Loggers::Stream(L, AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define ErrorL(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
 
 #define TEST_LOG_STRING "EXAMPLE_LOG_STRING"
 
@@ -25,6 +37,97 @@ protected:
     }
 };
 
+template<typename T, typename Sink>
+class FileSinkLogger : public T
+{
+public:
+    FileSinkLogger()
+    {
+        T::setFileSink(std::make_shared<Sink>());
+    }
+};
+
+template<typename T>
+using MappedFileLogger = FileSinkLogger<T, Sinks::MappedFileSink>;
+
+// To compare file sinks on throttled disk, run benchmark
+// from directory on required file system (for example
+// tmpfs vs. ext4 loopback device), logs are written to `./logs`.
+template<typename T>
+using UringFileLogger = FileSinkLogger<T, Sinks::UringFileSink>;
+
+template<std::size_t FormattingThreads>
+class ParallelAsyncLogger : public Loggers::AsyncLogger
+{
+public:
+    ParallelAsyncLogger() :
+        Loggers::AsyncLogger(FormattingThreads)
+    {}
+};
+
+class NullSink : public Sinks::AbstractSink
+{
+protected:
+    void onWrite(const AbstractLogger::Message&, const std::string& formatted) override
+    {
+        benchmark::DoNotOptimize(formatted.data());
+    }
+};
+
+/**
+ * @brief Sink policy of static logger, that
+ * does same work as `NullSink`.
+ */
+struct NullSinkPolicy
+{
+    bool accepts(AbstractLogger::ErrorClass) const
+    {
+        return true;
+    }
+
+    void write(const AbstractLogger::Message&, const std::string& formatted)
+    {
+        benchmark::DoNotOptimize(formatted.data());
+    }
+
+    void commit()
+    {}
+};
+
+#define DISPATCH_FORMAT "[%{ERROR_CLASS}] %{FILENAME}:%{LINE} %{CONTEXT}: %{MESSAGE}"
+
+static void virtualLoggerDispatch(benchmark::State& state)
+{
+    auto basicLogger = std::make_shared<Loggers::BasicLogger>();
+    basicLogger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    basicLogger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    basicLogger->setFormat(DISPATCH_FORMAT);
+    basicLogger->addSink(std::make_shared<NullSink>());
+
+    LoggerPtr logger = basicLogger;
+
+    for (auto _ : state)
+    {
+        logger->log(AbstractLogger::ErrorClass::Info, __FILENAME__, __LINE__, std::this_thread::get_id(),
+                    std::string(), __FUNCTION__, TEST_LOG_STRING);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void staticLoggerDispatch(benchmark::State& state)
+{
+    Loggers::StaticLogger<Loggers::DirectQueue, Formatters::PatternFormatter, NullSinkPolicy> logger(DISPATCH_FORMAT);
+
+    for (auto _ : state)
+    {
+        logger.log(AbstractLogger::ErrorClass::Info, __FILENAME__, __LINE__, std::this_thread::get_id(),
+                   std::string_view(), __FUNCTION__, TEST_LOG_STRING);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
 template<typename T>
 static void normalWithoutLogFileFunctionLogging(benchmark::State& state)
 {
@@ -39,7 +142,7 @@ static void normalWithoutLogFileFunctionLogging(benchmark::State& state)
     {
         for (int i = 0; i < state.range(0); ++i)
         {
-            InfoF(logger) << TEST_LOG_STRING;
+            InfoL(logger) << TEST_LOG_STRING;
         }
     }
 
@@ -61,7 +164,7 @@ static void normalWithLogFileFunctionLogging(benchmark::State& state)
     {
         for (int i = 0; i < state.range(0); ++i)
         {
-            InfoF(logger) << TEST_LOG_STRING;
+            InfoL(logger) << TEST_LOG_STRING;
         }
     }
 
@@ -83,7 +186,7 @@ static void suppressedFunctionLogging(benchmark::State& state)
     {
         for (int i = 0; i < state.range(0); ++i)
         {
-            InfoF(logger) << TEST_LOG_STRING;
+            InfoL(logger) << TEST_LOG_STRING;
         }
     }
 
@@ -91,6 +194,319 @@ static void suppressedFunctionLogging(benchmark::State& state)
     logger->waitForLogToBeWritten();
 }
 
+template<typename T, Sinks::FileSink::Durability Durability>
+static void durableFunctionLogging(benchmark::State& state)
+{
+    IostreamsLock lock;
+
+    auto logger = std::make_shared<T>();
+
+    logger->setMinimumTerminalOutputErrorClass(T::ErrorClass::None);
+    logger->fileSink()->setDurability(Durability);
+    logger->fileSink()->setSyncInterval(std::chrono::milliseconds(100));
+
+    // Creating log folder if it doesn't exists
+    createPath(logger->logPath());
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < state.range(0); ++i)
+        {
+            // Every 64th message has to be synced on group commit
+            if (i % 64 == 0)
+            {
+                ErrorL(logger) << TEST_LOG_STRING;
+            }
+            else
+            {
+                InfoL(logger) << TEST_LOG_STRING;
+            }
+        }
+
+        logger->waitForLogToBeWritten();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<bool Simd, bool Clean>
+static void sanitizeText(benchmark::State& state)
+{
+    Formatters::Sanitizer::setSimdEnabled(Simd);
+
+    std::string text;
+
+    // Clean text has to pass at memory speed, dirty
+    // text has newline and UTF-8 symbol every 64 bytes
+    while (text.size() < static_cast<std::size_t>(state.range(0)))
+    {
+        text += Clean ? TEST_LOG_STRING : "line\n\xd0\xbf";
+        text.resize(std::min<std::size_t>(text.size() + 48, state.range(0)), 'a');
+    }
+
+    std::string result;
+    result.reserve(text.size() * 2);
+
+    for (auto _ : state)
+    {
+        result.clear();
+        Formatters::Sanitizer::append(result, text, Formatters::Sanitizer::Mode::Json);
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(Formatters::Sanitizer::kernelName());
+
+    Formatters::Sanitizer::setSimdEnabled(true);
+}
+
+template<bool Simd>
+static void sanitizeUtf8Text(benchmark::State& state)
+{
+    Formatters::Sanitizer::setSimdEnabled(Simd);
+
+    std::string text;
+
+    // Valid non ASCII text without control characters
+    while (text.size() < static_cast<std::size_t>(state.range(0)))
+    {
+        text += "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 \xe4\xb8\x96\xe7\x95\x8c \xf0\x9f\x98\x80 ";
+    }
+
+    text.resize(state.range(0));
+
+    std::string result;
+    result.reserve(text.size() * 2);
+
+    for (auto _ : state)
+    {
+        result.clear();
+        Formatters::Sanitizer::append(result, text, Formatters::Sanitizer::Mode::Json);
+
+        benchmark::DoNotOptimize(result.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(Formatters::Sanitizer::kernelName());
+
+    Formatters::Sanitizer::setSimdEnabled(true);
+}
+
+static AbstractLogger::Message queueMessage()
+{
+    AbstractLogger::Message message;
+    message.timestamp = Logger::Clock::now();
+    message.errorClass = AbstractLogger::ErrorClass::Info;
+    message.thread = std::this_thread::get_id();
+    message.filename = __FILENAME__;
+    message.line = __LINE__;
+    message.context = "Network::Connection::onReceive";
+    message.message = "received packet of 1500 bytes from 10.0.0.1";
+
+    return message;
+}
+
+static void boundedQueuePushPop(benchmark::State& state)
+{
+    Logger::BoundedQueue<AbstractLogger::Message> queue(8192);
+
+    auto message = queueMessage();
+    AbstractLogger::Message result;
+    uint64_t position;
+
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            AbstractLogger::Message copy = message;
+            queue.tryPush(copy);
+        }
+
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            queue.tryPop(result, position);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_message"] = sizeof(std::atomic<uint64_t>) + sizeof(AbstractLogger::Message) +
+                                          message.context.capacity() + message.message.capacity() + 2;
+}
+
+static void recordQueuePushPop(benchmark::State& state)
+{
+    Logger::RecordQueue queue(16384);
+
+    auto message = queueMessage();
+    AbstractLogger::Message result;
+    uint64_t position;
+    uint64_t blocks;
+
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            queue.tryPush(message);
+        }
+
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            queue.tryPop(result, position, blocks);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_message"] = Logger::RecordQueue::blocksCount(message) * Logger::RecordQueue::BlockSize;
+}
+
+template<bool Shared>
+static void currentLoggerLogging(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        CurrentLogger::setCurrentLogger(std::make_shared<DummyLogger>());
+    }
+
+    for (auto _ : state)
+    {
+        // Shared pointer copy is previous way of taking current logger
+        if constexpr (Shared)
+        {
+            Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Info, __FILENAME__, __LINE__,
+                            std::this_thread::get_id(), std::string(), __FUNCTION__) << TEST_LOG_STRING;
+        }
+        else
+        {
+            InfoEx("Benchmark") << TEST_LOG_STRING;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        CurrentLogger::setCurrentLogger(nullptr);
+    }
+}
+
+template<bool Lazy>
+static void disabledMessageLogging(benchmark::State& state)
+{
+    CurrentLogger::setCurrentLogger(std::make_shared<DummyLogger>());
+    Logger::Categories::setLevel("Benchmark", AbstractLogger::ErrorClass::Info);
+
+    std::vector<int> values(64, 42);
+
+    auto expensive = [&values]()
+    {
+        std::string result;
+
+        for (auto value : values)
+        {
+            result += std::to_string(value);
+        }
+
+        return result;
+    };
+
+    for (auto _ : state)
+    {
+        // Stream is created before check is previous way
+        if constexpr (Lazy)
+        {
+            DebugEx("Benchmark") << expensive();
+        }
+        else
+        {
+            Loggers::Stream(CurrentLogger::Reference().get(), AbstractLogger::ErrorClass::Debug, __FILENAME__, __LINE__,
+                            std::this_thread::get_id(), "Benchmark", __FUNCTION__,
+                            ALOGGER_CALL_SITE().action(AbstractLogger::ErrorClass::Debug, "Benchmark")) << expensive();
+        }
+    }
+
+    Logger::Categories::resetLevel("Benchmark");
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+static void backtraceCapture(benchmark::State& state)
+{
+    std::vector<void*> frames;
+
+    for (auto _ : state)
+    {
+        Logger::Backtrace::capture(frames, 0);
+        benchmark::DoNotOptimize(frames.data());
+    }
+
+    state.counters["frames"] = static_cast<double>(frames.size());
+}
+
+static void backtraceSymbolize(benchmark::State& state)
+{
+    std::vector<void*> frames;
+    Logger::Backtrace::capture(frames, 0);
+
+    for (auto _ : state)
+    {
+        for (auto frame : frames)
+        {
+            benchmark::DoNotOptimize(Logger::Backtrace::symbolize(frame));
+        }
+    }
+}
+
+class DummyTraceSink : public Sinks::AbstractSink
+{
+public:
+    bool acceptsSpans() const override
+    {
+        return true;
+    }
+
+protected:
+    void onWrite(const AbstractLogger::Message&, const std::string&) override
+    {
+    }
+};
+
+template<bool Enabled>
+static void traceSpan(benchmark::State& state)
+{
+    auto logger = std::make_shared<DummyLogger>();
+    logger->addSink(std::make_shared<DummyTraceSink>());
+
+    CurrentLogger::setCurrentLogger(logger);
+    Logger::TraceSpan::setEnabled(Enabled);
+
+    for (auto _ : state)
+    {
+        LogScope("benchmark");
+    }
+
+    Logger::TraceSpan::setEnabled(false);
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+template<Logger::Clock::Source Source>
+static void clockTimestamp(benchmark::State& state)
+{
+    if (!Logger::Clock::isAvailable(Source))
+    {
+        state.SkipWithError("Clock source is not available");
+        return;
+    }
+
+    Logger::Clock::setSource(Source);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Logger::Clock::now());
+    }
+
+    Logger::Clock::setSource(Logger::Clock::Source::System);
+}
+
 constexpr int RANGE_START = 1;
 constexpr int RANGE_END = 1 << 15;
 
@@ -114,6 +530,39 @@ BENCHMARK_TEMPLATE(suppressedFunctionLogging,           Loggers::AsyncLogger)
     ->Range(RANGE_START, RANGE_END)
     ->Complexity();
 
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    ParallelAsyncLogger<2>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    ParallelAsyncLogger<4>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    MappedFileLogger<Loggers::BasicLogger>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    MappedFileLogger<Loggers::AsyncLogger>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    UringFileLogger<Loggers::BasicLogger>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    UringFileLogger<Loggers::AsyncLogger>)
+    ->Range(RANGE_START, RANGE_END)
+    ->Complexity();
+
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::BasicLogger, Sinks::FileSink::Durability::None)
+    ->Arg(RANGE_END);
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::BasicLogger, Sinks::FileSink::Durability::Periodic)
+    ->Arg(RANGE_END);
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::BasicLogger, Sinks::FileSink::Durability::GroupCommit)
+    ->Arg(RANGE_END);
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::AsyncLogger, Sinks::FileSink::Durability::None)
+    ->Arg(RANGE_END);
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::AsyncLogger, Sinks::FileSink::Durability::Periodic)
+    ->Arg(RANGE_END);
+BENCHMARK_TEMPLATE(durableFunctionLogging, Loggers::AsyncLogger, Sinks::FileSink::Durability::GroupCommit)
+    ->Arg(RANGE_END);
+
 BENCHMARK_TEMPLATE(normalWithLogFileFunctionLogging,    DummyLogger)
     ->Range(RANGE_START, RANGE_END)
     ->Complexity();
@@ -124,4 +573,33 @@ BENCHMARK_TEMPLATE(suppressedFunctionLogging,           DummyLogger)
     ->Range(RANGE_START, RANGE_END)
     ->Complexity();
 
+BENCHMARK_TEMPLATE(sanitizeText, true,  true) ->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(sanitizeText, false, true) ->Arg(64)->Arg(4096);
+BENCHMARK_TEMPLATE(sanitizeText, true,  false)->Arg(4096);
+BENCHMARK_TEMPLATE(sanitizeText, false, false)->Arg(4096);
+BENCHMARK_TEMPLATE(sanitizeUtf8Text, true) ->Arg(4096);
+BENCHMARK_TEMPLATE(sanitizeUtf8Text, false)->Arg(4096);
+
+BENCHMARK(virtualLoggerDispatch);
+BENCHMARK(staticLoggerDispatch);
+
+BENCHMARK_TEMPLATE(currentLoggerLogging, true) ->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(currentLoggerLogging, false)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(disabledMessageLogging, true);
+BENCHMARK_TEMPLATE(disabledMessageLogging, false);
+
+BENCHMARK(boundedQueuePushPop)->Arg(64)->Arg(4096);
+BENCHMARK(recordQueuePushPop) ->Arg(64)->Arg(4096);
+
+BENCHMARK(backtraceCapture);
+BENCHMARK(backtraceSymbolize);
+
+BENCHMARK_TEMPLATE(traceSpan, true);
+BENCHMARK_TEMPLATE(traceSpan, false);
+
+BENCHMARK_TEMPLATE(clockTimestamp, Logger::Clock::Source::System);
+BENCHMARK_TEMPLATE(clockTimestamp, Logger::Clock::Source::Coarse);
+BENCHMARK_TEMPLATE(clockTimestamp, Logger::Clock::Source::Tsc);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Stack traces of messages. Logging thread
+     * captures only raw return addresses, they are
+     * symbolized and demangled by formatter (in writing
+     * thread of async logger). Symbolized addresses are
+     * cached, so repeated errors from same place are
+     * not resolved again.
+     */
+    class Backtrace
+    {
+    public:
+        // Maximum number of captured frames
+        static constexpr std::size_t MaximumFrames = 32;
+
+        /**
+         * @brief Method for setting minimum error class
+         * of messages with stack trace. Default value
+         * is `None`, so traces are not captured.
+         * @param errorClass Error class.
+         */
+        static void setLevel(AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for getting minimum error
+         * class of messages with stack trace.
+         * @return Error class.
+         */
+        static AbstractLogger::ErrorClass level();
+
+        /**
+         * @brief Method for checking is stack trace
+         * captured for message with error class.
+         * @param errorClass Message error class.
+         * @return Is stack trace captured.
+         */
+        static bool isCaptured(AbstractLogger::ErrorClass errorClass)
+        {
+            return errorClass >= m_level.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Method for capturing return addresses
+         * of current thread stack. Nothing is resolved.
+         * @param frames Result addresses, innermost first.
+         * @param skip Number of frames to skip, besides
+         * frame of this method.
+         */
+        static void capture(std::vector<void*>& frames, std::size_t skip);
+
+        /**
+         * @brief Method for getting symbol of address,
+         * like `Class::method()+0x1c (module)`. Result is
+         * cached. Thread safe.
+         * @param address Return address.
+         * @return Symbol or address, if it can't be resolved.
+         */
+        static std::string symbolize(void* address);
+
+        /**
+         * @brief Method for getting number of
+         * cached symbolized addresses.
+         * @return Cache size.
+         */
+        static std::size_t cacheSize();
+
+    private:
+        static std::atomic<AbstractLogger::ErrorClass> m_level;
+    };
+}
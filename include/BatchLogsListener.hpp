@@ -0,0 +1,173 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <string_view>
+#include "LogsListener.hpp"
+#include "MessagesRing.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Struct, that describes message,
+     * borrowed from logger without copying. Strings
+     * are pointing into shared message record and
+     * are valid until batch is released.
+     */
+    struct MessageView
+    {
+        std::chrono::system_clock::time_point timePoint;
+        AbstractLogger::ErrorClass errorClass;
+        std::string_view message;
+        std::thread::id thread;
+        const char* filename;
+        std::string_view context;
+        int line;
+    };
+
+    /**
+     * @brief Class, that describes span of
+     * borrowed messages. Batch object can be
+     * reused to avoid allocations.
+     */
+    class MessagesBatch
+    {
+    public:
+        using const_iterator = std::vector<MessageView>::const_iterator;
+
+        /**
+         * @brief Constructor.
+         */
+        MessagesBatch();
+
+        /**
+         * @brief Method for getting number of
+         * messages in batch.
+         * @return Number of messages.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Method for checking is batch empty.
+         * @return Is batch empty.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Method for getting message by index.
+         * @param index Message index.
+         * @return Message view.
+         */
+        const MessageView& operator[](std::size_t index) const;
+
+        /**
+         * @brief Method for getting begin iterator.
+         * @return Iterator.
+         */
+        const_iterator begin() const;
+
+        /**
+         * @brief Method for getting end iterator.
+         * @return Iterator.
+         */
+        const_iterator end() const;
+
+    private:
+        friend class BatchLogsListener;
+
+        /**
+         * @brief Method for dropping borrowed records.
+         */
+        void clear();
+
+        std::vector<MessagesRing::MessagePtr> m_records;
+        std::vector<MessageView> m_views;
+        uint64_t m_endCursor;
+    };
+
+    /**
+     * @brief Logs listener, that pulls messages
+     * from logger by batches, without copying
+     * message strings. Messages are not passed to
+     * `newMessage`, consumer has to take them with
+     * `borrowMessages` and give them back with
+     * `releaseMessages`. If consumer is too slow
+     * oldest messages are skipped.
+     */
+    class BatchLogsListener : public LogsListener
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        BatchLogsListener();
+
+        /**
+         * @brief Method for borrowing messages.
+         * Messages stay available until they are released.
+         * Borrowing without releasing returns same messages.
+         * @param batch Batch, that will be filled.
+         * @param maximum Maximum number of messages.
+         * @return Is there any borrowed messages.
+         */
+        bool borrowMessages(MessagesBatch& batch, std::size_t maximum = 1024);
+
+        /**
+         * @brief Method for releasing borrowed messages.
+         * Batch will be cleared.
+         * @param batch Borrowed batch.
+         */
+        void releaseMessages(MessagesBatch& batch);
+
+        /**
+         * @brief Method for getting number of
+         * messages, that was skipped because
+         * consumer was too slow.
+         * @return Number of messages.
+         */
+        uint64_t droppedMessages() const;
+
+        /**
+         * @brief Method for popping one message
+         * by copy. Prefer `borrowMessages`.
+         * @return Message.
+         */
+        AbstractLogger::Message popMessage() override;
+
+        /**
+         * @brief Method for checking is there
+         * any messages to borrow.
+         * @return Is messages inside.
+         */
+        bool hasMessages() const override;
+
+        /**
+         * @brief Not used. Messages are pulled.
+         */
+        void newMessage(const AbstractLogger::Message& m) override;
+
+    private:
+        friend class ListenersDispatcher;
+
+        /**
+         * @brief Method for attaching listener to
+         * logger ring. Listener will receive messages
+         * logged after this call.
+         * @param ring Messages ring.
+         */
+        void attach(std::shared_ptr<MessagesRing> ring);
+
+        /**
+         * @brief Method for detaching listener
+         * from logger ring.
+         * @param ring Messages ring.
+         */
+        void detach(const std::shared_ptr<MessagesRing>& ring);
+
+        mutable std::mutex m_mutex;
+        std::shared_ptr<MessagesRing> m_ring;
+        uint64_t m_cursor;
+        uint64_t m_dropped;
+    };
+}
+
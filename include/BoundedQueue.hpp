@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace Logger
+{
+    /**
+     * @brief Lock free bounded queue with
+     * many producers and many consumers. Every
+     * slot has it's own sequence number, so
+     * elements, that are pushed and not popped
+     * yet can be visited without locks (for
+     * example from signal handler).
+     * @tparam T Element type.
+     */
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @param capacity Maximum number of elements.
+         * Will be rounded up to power of two.
+         */
+        explicit BoundedQueue(std::size_t capacity) :
+            m_slots(),
+            m_capacity(1),
+            m_enqueuePosition(0),
+            m_dequeuePosition(0)
+        {
+            while (m_capacity < capacity)
+            {
+                m_capacity <<= 1;
+            }
+
+            m_slots = std::make_unique<Slot[]>(m_capacity);
+
+            for (uint64_t i = 0; i < m_capacity; ++i)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Method for pushing element.
+         * @param value Value. It's moved only on success.
+         * @return Is value pushed. False if queue is full.
+         */
+        bool tryPush(T& value)
+        {
+            auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & (m_capacity - 1)];
+                auto sequence = slot.sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<int64_t>(sequence - position);
+
+                if (difference == 0)
+                {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = std::move(value);
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Method for popping element.
+         * @param value Result value.
+         * @param position Result position of element
+         * in queue. Positions are consecutive in push order.
+         * @return Is value popped. False if queue is empty.
+         */
+        bool tryPop(T& value, uint64_t& position)
+        {
+            position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                auto& slot = m_slots[position & (m_capacity - 1)];
+                auto sequence = slot.sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<int64_t>(sequence - (position + 1));
+
+                if (difference == 0)
+                {
+                    if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        value = std::move(slot.value);
+                        slot.sequence.store(position + m_capacity, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Method for getting approximate
+         * number of elements.
+         * @return Number of elements.
+         */
+        std::size_t size() const
+        {
+            auto dequeue = m_dequeuePosition.load();
+            auto enqueue = m_enqueuePosition.load();
+
+            return enqueue > dequeue ? enqueue - dequeue : 0;
+        }
+
+        /**
+         * @brief Method for getting position of
+         * next pushed element. It's number of pushes,
+         * that are done or in progress.
+         * @return Position.
+         */
+        uint64_t pushPosition() const
+        {
+            return m_enqueuePosition.load();
+        }
+
+        /**
+         * @brief Method for checking is queue empty.
+         * @return Is queue empty.
+         */
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Method for visiting elements, that are
+         * pushed and not popped yet. It does not lock
+         * anything and does not allocate memory, so it
+         * can be used from signal handler. Elements can
+         * be popped while visiting, so it's best effort.
+         * @param visitor Callable, that receives `const T&`.
+         */
+        template<typename Visitor>
+        void visit(Visitor&& visitor) const
+        {
+            auto enqueue = m_enqueuePosition.load();
+
+            for (auto position = m_dequeuePosition.load(); position < enqueue; ++position)
+            {
+                auto& slot = m_slots[position & (m_capacity - 1)];
+
+                if (slot.sequence.load(std::memory_order_acquire) == position + 1)
+                {
+                    visitor(slot.value);
+                }
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        uint64_t m_capacity;
+
+        alignas(64) std::atomic<uint64_t> m_enqueuePosition;
+        alignas(64) std::atomic<uint64_t> m_dequeuePosition;
+    };
+}
+
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <cstdint>
+#include <chrono>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Struct, that describes limits
+     * of messages from one call site.
+     */
+    struct RateLimit
+    {
+        // Maximum average number of messages per second.
+        // 0 means, that rate is not limited.
+        double messagesPerSecond = 0;
+
+        // Number of messages, that can be passed at once.
+        uint32_t burst = 1;
+
+        // Only every N-th message is passed.
+        uint32_t sampleEvery = 1;
+    };
+
+    /**
+     * @brief Global registry of log categories
+     * levels. Category is class name with namespaces,
+     * like `Network::Socket`. Level of category is
+     * taken from closest parent with override, so
+     * setting level for `Network` (or `Network::*`)
+     * changes all classes inside `Network` namespace.
+     * Root category is empty string, by default it
+     * passes everything to logger. Call sites also
+     * skip messages, that current logger doesn't accept.
+     */
+    class Categories
+    {
+    public:
+        /**
+         * @brief Method for setting category level
+         * override. Thread safe.
+         * @param category Category name. Trailing `::*`
+         * is ignored.
+         * @param errorClass Minimum error class.
+         */
+        static void setLevel(const std::string& category, AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for removing category
+         * level override. Thread safe.
+         * @param category Category name.
+         */
+        static void resetLevel(const std::string& category);
+
+        /**
+         * @brief Method for setting level of categories
+         * without overrides.
+         * @param errorClass Minimum error class.
+         */
+        static void setDefaultLevel(AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for getting effective
+         * level of category.
+         * @param category Category name.
+         * @return Minimum error class.
+         */
+        static AbstractLogger::ErrorClass level(const std::string& category);
+
+        /**
+         * @brief Method for setting call sites rate
+         * limit for category. Every call site has it's own
+         * token bucket and sampling counter. Thread safe.
+         * @param category Category name. Trailing `::*`
+         * is ignored.
+         * @param limit Rate limit.
+         */
+        static void setRateLimit(const std::string& category, RateLimit limit);
+
+        /**
+         * @brief Method for removing category rate
+         * limit override. Thread safe.
+         * @param category Category name.
+         */
+        static void resetRateLimit(const std::string& category);
+
+        /**
+         * @brief Method for setting rate limit
+         * of categories without overrides.
+         * @param limit Rate limit.
+         */
+        static void setDefaultRateLimit(RateLimit limit);
+
+        /**
+         * @brief Method for getting effective
+         * rate limit of category.
+         * @param category Category name.
+         * @return Rate limit.
+         */
+        static RateLimit rateLimit(const std::string& category);
+
+        /**
+         * @brief Method for setting interval of summary
+         * about suppressed messages. Summary is logged
+         * as warning into current logger by background
+         * thread, when interval is passed after first
+         * suppressed message. Default value is 10 seconds.
+         * @param interval Interval.
+         */
+        static void setSuppressedSummaryInterval(std::chrono::milliseconds interval);
+
+        /**
+         * @brief Method for getting interval of
+         * summary about suppressed messages.
+         * @return Interval.
+         */
+        static std::chrono::milliseconds suppressedSummaryInterval();
+
+        /**
+         * @brief Method for getting configuration
+         * generation. It's changed on every level change.
+         * @return Generation.
+         */
+        static uint64_t generation()
+        {
+            return m_generation.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Method for changing configuration
+         * generation, so call sites refresh cached levels.
+         * It's called on changes of current logger, it's
+         * sinks and listeners.
+         */
+        static void invalidate();
+
+        /**
+         * @brief Method for getting category name
+         * from type. Template arguments are dropped.
+         * @param type Type info.
+         * @return Category name.
+         */
+        static std::string typeCategory(const std::type_info& type);
+
+        /**
+         * @brief Method for getting demangled type name.
+         * @param type Type info.
+         * @return Type name.
+         */
+        static std::string typeName(const std::type_info& type);
+
+    private:
+        friend class FlightRecorder;
+
+        static std::atomic<uint64_t> m_generation;
+        static std::atomic<std::chrono::milliseconds> m_summaryInterval;
+    };
+
+    /**
+     * @brief Class, that caches effective level
+     * of one logging call site. Cached value is
+     * refreshed when categories generation changes,
+     * so check costs one load and compare. Rate
+     * limits are checked lock free only for sites,
+     * that have them. It's created as function static
+     * by logging macros.
+     */
+    class CallSite
+    {
+    public:
+        /**
+         * @brief What has to be done with message.
+         */
+        enum class Action
+        {
+            Skip     //< Message is dropped.
+            , Record //< Message is below output level, it's stored only by flight recorder.
+            , Log    //< Message is passed to logger.
+        };
+
+        /**
+         * @brief Constructor.
+         * @param filename Source filename.
+         * @param line Source line.
+         */
+        constexpr CallSite(const char* filename, int line) :
+            m_state(0),
+            m_interval(0),
+            m_tolerance(0),
+            m_sampleEvery(1),
+            m_sampleCounter(0),
+            m_arrivalTime(0),
+            m_suppressed(0),
+            m_registered(false),
+            m_next(nullptr),
+            m_typeName(nullptr),
+            m_filename(filename),
+            m_line(line)
+        {
+
+        }
+
+        /**
+         * @brief Method for taking summary about
+         * suppressed messages, if summary interval
+         * is passed. Counters are reset.
+         * @param summary Result summary.
+         * @return Is summary taken.
+         */
+        static bool takeSuppressedSummary(std::string& summary);
+
+        /**
+         * @brief Method for getting action for
+         * message from class call site.
+         * @param errorClass Message error class.
+         * @param type Static type of class, that's logging.
+         * @return Message action.
+         */
+        Action action(AbstractLogger::ErrorClass errorClass, const std::type_info& type)
+        {
+            auto state = m_state.load(std::memory_order_relaxed);
+
+            if ((state >> 8) != Categories::generation())
+            {
+                state = refresh(Categories::typeCategory(type));
+            }
+
+            return check(errorClass, state);
+        }
+
+        /**
+         * @brief Method for getting action for
+         * message from free function call site.
+         * Root category is used.
+         * @param errorClass Message error class.
+         * @return Message action.
+         */
+        Action action(AbstractLogger::ErrorClass errorClass)
+        {
+            auto state = m_state.load(std::memory_order_relaxed);
+
+            if ((state >> 8) != Categories::generation())
+            {
+                state = refresh(std::string());
+            }
+
+            return check(errorClass, state);
+        }
+
+        /**
+         * @brief Method for getting action for
+         * message from call site with explicit category.
+         * Category can be different on every call, so
+         * last category of site is cached per thread.
+         * @param errorClass Message error class.
+         * @param category Category name.
+         * @return Message action.
+         */
+        Action action(AbstractLogger::ErrorClass errorClass, std::string_view category)
+        {
+            return check(errorClass, categoryState(category));
+        }
+
+        /**
+         * @brief Method for getting name of class, that's
+         * logging from class call site. It's same static
+         * type, that gives category. Name is demangled once.
+         * @param type Static type of class, that's logging.
+         * @return Type name.
+         */
+        const std::string& typeName(const std::type_info& type)
+        {
+            auto name = m_typeName.load(std::memory_order_acquire);
+
+            if (name == nullptr)
+            {
+                name = storeTypeName(type);
+            }
+
+            return *name;
+        }
+
+    private:
+        // State bit, that's set for sites with rate limits
+        static constexpr uint64_t LimitedFlag = 0x80;
+
+        /**
+         * @brief Method for checking message
+         * against cached state.
+         * @param errorClass Message error class.
+         * @param state Cached state.
+         * @return Message action.
+         */
+        Action check(AbstractLogger::ErrorClass errorClass, uint64_t state)
+        {
+            auto level = static_cast<uint64_t>(errorClass);
+
+            // Output level in bits 0-2, recorder level in bits 3-5
+            if (level < (state & 0x07))
+            {
+                return level < ((state >> 3) & 0x07) ? Action::Skip : Action::Record;
+            }
+
+            if ((state & LimitedFlag) == 0 || isAllowed())
+            {
+                return Action::Log;
+            }
+
+            return Action::Skip;
+        }
+
+        /**
+         * @brief Method for checking sampling and
+         * token bucket of site.
+         * @return Is message allowed.
+         */
+        bool isAllowed();
+
+        /**
+         * @brief Method for counting suppressed message.
+         */
+        void suppress();
+
+        /**
+         * @brief Method for updating cached level.
+         * @param category Call site category.
+         * @return New state.
+         */
+        uint64_t refresh(const std::string& category);
+
+        /**
+         * @brief Method for resolving state of category
+         * without storing it as site state. Rate limit
+         * values are stored only if they are changed.
+         * @param category Call site category.
+         * @return State.
+         */
+        uint64_t resolve(const std::string& category);
+
+        /**
+         * @brief Method for getting state of explicit
+         * category. Resolved state is cached in thread
+         * local cache until generation or category change.
+         * @param category Category name.
+         * @return State.
+         */
+        uint64_t categoryState(std::string_view category);
+
+        /**
+         * @brief Method for demangling and storing
+         * type name of site.
+         * @param type Type info.
+         * @return Stored name.
+         */
+        const std::string* storeTypeName(const std::type_info& type);
+
+        // Generation in high bits, levels and limit flag in low byte.
+        // Generation 0 means, that site is not resolved.
+        std::atomic<uint64_t> m_state;
+
+        // Token bucket as virtual arrival time in nanoseconds
+        std::atomic<uint64_t> m_interval;
+        std::atomic<uint64_t> m_tolerance;
+        std::atomic<uint32_t> m_sampleEvery;
+        std::atomic<uint32_t> m_sampleCounter;
+        std::atomic<uint64_t> m_arrivalTime;
+
+        // Suppressed messages since last summary
+        std::atomic<uint64_t> m_suppressed;
+        std::atomic_bool m_registered;
+        CallSite* m_next;
+
+        // Demangled type name of class site. Sites are
+        // static, so name is never released.
+        std::atomic<const std::string*> m_typeName;
+
+        const char* m_filename;
+        int m_line;
+    };
+}
+
+/**
+ * @brief Macro, that returns call site
+ * object, unique for every expansion.
+ */
+#define ALOGGER_CALL_SITE() ([]() -> Logger::CallSite& { static Logger::CallSite site(__FILE__, __LINE__); return site; }())
+
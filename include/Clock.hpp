@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Logger
+{
+    /**
+     * @brief Global clock of message timestamps.
+     * Timestamp is taken at call site as raw clock
+     * value and converted to wall time only by
+     * formatters, so messages, that are dropped
+     * later, cost only one clock read.
+     *
+     * Sources:
+     * `System` - `std::chrono::system_clock`. Default.
+     * `Coarse` - `CLOCK_REALTIME_COARSE`, precision is
+     * about one millisecond, but reading is cheaper.
+     * Available only on Linux.
+     * `Tsc`    - CPU timestamp counter. It's calibrated against
+     * `CLOCK_REALTIME` on selection and then every second by
+     * thread, that converts timestamps. Available only on x86
+     * with invariant TSC.
+     */
+    class Clock
+    {
+    public:
+        enum class Source
+        {
+            System
+            , Coarse
+            , Tsc
+        };
+
+        // Bit, that marks TSC timestamps. Other
+        // timestamps are nanoseconds since epoch.
+        static constexpr uint64_t TscFlag = 1ULL << 63;
+
+        /**
+         * @brief Method for setting clock source.
+         * Timestamps, taken with previous source, are
+         * still converted correctly. Calibrates TSC on first
+         * selection, it takes about 20 milliseconds.
+         * Throws std::runtime_error if source is not available.
+         * @param source Clock source.
+         */
+        static void setSource(Source source);
+
+        /**
+         * @brief Method for getting clock source.
+         * @return Clock source.
+         */
+        static Source source()
+        {
+            return m_source.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Method for checking is source
+         * available on this system.
+         * @param source Clock source.
+         * @return Is source available.
+         */
+        static bool isAvailable(Source source);
+
+        /**
+         * @brief Method for taking raw timestamp
+         * with current source.
+         * @return Raw timestamp.
+         */
+        static uint64_t now();
+
+        /**
+         * @brief Method for converting raw timestamp
+         * to wall time. Thread safe.
+         * @param timestamp Raw timestamp.
+         * @return Time point.
+         */
+        static std::chrono::system_clock::time_point toTimePoint(uint64_t timestamp);
+
+        /**
+         * @brief Copy of TSC calibration in plain
+         * values. It's used, where clock state can't
+         * be touched, like signal handlers.
+         */
+        struct Snapshot
+        {
+            uint64_t baseTicks = 0;
+            int64_t baseNanoseconds = 0;
+            double nanosecondsPerTick = 0.0;
+        };
+
+        /**
+         * @brief Method for taking copy of current
+         * calibration. Thread safe.
+         * @return Calibration snapshot.
+         */
+        static Snapshot snapshot();
+
+        /**
+         * @brief Method for converting raw timestamp to
+         * nanoseconds since epoch with calibration snapshot.
+         * It doesn't touch clock state and doesn't recalibrate,
+         * so it's async signal safe.
+         * @param timestamp Raw timestamp.
+         * @param snapshot Calibration snapshot.
+         * @return Nanoseconds since epoch.
+         */
+        static int64_t toNanoseconds(uint64_t timestamp, const Snapshot& snapshot) noexcept;
+
+    private:
+        static std::atomic<Source> m_source;
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Local logs collector. Receives records
+     * from `Sinks::CollectorSink` of several processes
+     * through Unix datagram socket and writes them to
+     * one sink. So only collector owns log files rotation
+     * and batching. Records are written from dedicated
+     * thread. Available only on Linux.
+     *
+     * Every datagram contains batch of records. Record is
+     * 4 bytes of text size, 1 byte of error class and text,
+     * that's already formatted by sender.
+     */
+    class Collector
+    {
+    public:
+        Collector(const Collector&) = delete;
+        Collector& operator=(const Collector&) = delete;
+
+        // Maximum size of one datagram
+        static constexpr std::size_t MaximumDatagramSize = 64 * 1024;
+
+        // Size of record header in datagram
+        static constexpr std::size_t RecordHeaderSize = 5;
+
+        /**
+         * @brief Constructor. Binds socket and starts
+         * receiving thread. Existing socket file is
+         * replaced. Throws std::runtime_error on failure.
+         * @param socketPath Path to socket file.
+         * @param sink Sink, that receives all records.
+         */
+        Collector(std::string socketPath, Sinks::SinkPtr sink);
+
+        /**
+         * @brief Destructor. Stops receiving and
+         * removes socket file.
+         */
+        ~Collector();
+
+        /**
+         * @brief Method for getting socket path.
+         * @return Path to socket file.
+         */
+        const std::string& socketPath() const;
+
+        /**
+         * @brief Method for getting number of
+         * records, written by collector.
+         * @return Number of records.
+         */
+        uint64_t receivedRecords() const;
+
+    private:
+        /**
+         * @brief Receiving thread body.
+         */
+        void receivingThread();
+
+        std::string m_socketPath;
+        Sinks::SinkPtr m_sink;
+        int m_fd;
+        std::atomic_bool m_running;
+        std::atomic<uint64_t> m_receivedRecords;
+        std::thread m_thread;
+    };
+}
@@ -2,39 +2,138 @@
 
 #include "Loggers/AbstractLogger.hpp"
 #include <Stream.hpp>
+#include <Categories.hpp>
+#include <Epoch.hpp>
 #include <cstring>
 #include <SystemTools.h>
 
-#define Debug()     Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), SystemTools::getTypeName(*this), __FUNCTION__)
-#define Info()      Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), SystemTools::getTypeName(*this), __FUNCTION__)
-#define Warning()   Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), SystemTools::getTypeName(*this), __FUNCTION__)
-#define Error()     Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), SystemTools::getTypeName(*this), __FUNCTION__)
+// Call site action is checked before stream creation,
+// so operands of disabled message are not evaluated
+#define ALOGGER_STREAM(ERROR_CLASS, CLASSNAME, ACTION) \
+    !Loggers::StreamGate::open(ACTION) \
+        ? (void) 0 \
+        : Loggers::StreamGate() & Loggers::Stream(CurrentLogger::Reference().get(), ERROR_CLASS, __FILENAME__, __LINE__, std::this_thread::get_id(), CLASSNAME, __FUNCTION__, Loggers::StreamGate::action())
 
-#define DebugF()    Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define InfoF()     Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define WarningF()  Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define ErrorF()    Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+// Class name is evaluated once and passed
+// from call site check to stream by gate
+#define ALOGGER_STREAM_EX(ERROR_CLASS, CLASSNAME) \
+    ALOGGER_STREAM(ERROR_CLASS, std::string(Loggers::StreamGate::classname()), ALOGGER_CALL_SITE().action(ERROR_CLASS, Loggers::StreamGate::classname(CLASSNAME)))
 
-#define DebugEx(CLASSNAME)    Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), CLASSNAME, __FUNCTION__)
-#define InfoEx(CLASSNAME)     Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), CLASSNAME, __FUNCTION__)
-#define WarningEx(CLASSNAME)  Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), CLASSNAME, __FUNCTION__)
-#define ErrorEx(CLASSNAME)    Loggers::Stream(CurrentLogger::i(), AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), CLASSNAME, __FUNCTION__)
+// Class name and category are taken from static type,
+// name is demangled once per call site
+#define ALOGGER_STREAM_CLASS(ERROR_CLASS) \
+    ALOGGER_STREAM(ERROR_CLASS, std::string(Loggers::StreamGate::classname()), Loggers::StreamGate::classAction(ALOGGER_CALL_SITE(), ERROR_CLASS, typeid(std::remove_reference_t<decltype(*this)>)))
+
+#define Debug()     ALOGGER_STREAM_CLASS(AbstractLogger::ErrorClass::Debug)
+#define Info()      ALOGGER_STREAM_CLASS(AbstractLogger::ErrorClass::Info)
+#define Warning()   ALOGGER_STREAM_CLASS(AbstractLogger::ErrorClass::Warning)
+#define Error()     ALOGGER_STREAM_CLASS(AbstractLogger::ErrorClass::Error)
+
+#define DebugF()    ALOGGER_STREAM(AbstractLogger::ErrorClass::Debug, std::string(), ALOGGER_CALL_SITE().action(AbstractLogger::ErrorClass::Debug))
+#define InfoF()     ALOGGER_STREAM(AbstractLogger::ErrorClass::Info, std::string(), ALOGGER_CALL_SITE().action(AbstractLogger::ErrorClass::Info))
+#define WarningF()  ALOGGER_STREAM(AbstractLogger::ErrorClass::Warning, std::string(), ALOGGER_CALL_SITE().action(AbstractLogger::ErrorClass::Warning))
+#define ErrorF()    ALOGGER_STREAM(AbstractLogger::ErrorClass::Error, std::string(), ALOGGER_CALL_SITE().action(AbstractLogger::ErrorClass::Error))
+
+#define DebugEx(CLASSNAME)    ALOGGER_STREAM_EX(AbstractLogger::ErrorClass::Debug, CLASSNAME)
+#define InfoEx(CLASSNAME)     ALOGGER_STREAM_EX(AbstractLogger::ErrorClass::Info, CLASSNAME)
+#define WarningEx(CLASSNAME)  ALOGGER_STREAM_EX(AbstractLogger::ErrorClass::Warning, CLASSNAME)
+#define ErrorEx(CLASSNAME)    ALOGGER_STREAM_EX(AbstractLogger::ErrorClass::Error, CLASSNAME)
 
 /**
- * @brief Current logger singleton.
+ * @brief Current logger singleton. Logger is
+ * kept as plain atomic pointer, replaced logger
+ * is released after all readers, that could see
+ * it, leave epoch critical section and unpin it.
+ * So logging macros don't touch shared pointer
+ * counter.
  */
 class CurrentLogger
 {
 public:
 
+    /**
+     * @brief RAII object, that takes current logger
+     * and pins it. Logger is taken inside short epoch
+     * critical section, so section doesn't include
+     * message operands and logger call, only pin counter
+     * keeps logger alive until object destruction. Used
+     * by logging macros as temporary, so it outlives
+     * logger stream.
+     */
+    class Reference
+    {
+    public:
+        Reference(const Reference&) = delete;
+        Reference& operator=(const Reference&) = delete;
+
+        /**
+         * @brief Constructor.
+         */
+        Reference();
+
+        /**
+         * @brief Destructor. Unpins logger. Last
+         * unpin releases retired loggers. Logger is
+         * not touched after unpin, it can be
+         * already released by other thread.
+         */
+        ~Reference()
+        {
+            if (m_pin != nullptr &&
+                m_pin->fetch_sub(1) == 1 &&
+                m_retiredCount.load() != 0)
+            {
+                releaseRetired();
+            }
+        }
+
+        /**
+         * @brief Method for getting logger.
+         * @return Pointer to current logger or
+         * nullptr if there is no logger.
+         */
+        AbstractLogger* get() const
+        {
+            return m_logger;
+        }
+
+    private:
+        AbstractLogger* m_logger;
+        std::atomic<int64_t>* m_pin;
+    };
+
     /**
      * @brief Method for getting current global logger.
+     * Throws std::runtime_error if there is no logger.
      * @return Pointer to current logger.
      */
     static LoggerPtr i();
 
+    /**
+     * @brief Method for getting current global logger
+     * without reference counting. Has to be called inside
+     * `Epoch::ReadGuard` section, result is valid until
+     * section end.
+     * @return Pointer to current logger or nullptr.
+     */
+    static AbstractLogger* current() noexcept
+    {
+        return m_current.load();
+    }
+
+    /**
+     * @brief Method for getting minimum error class of
+     * messages, that current logger accepts. Value is
+     * cached until categories generation change.
+     * @return Error class. `None` if there is no logger.
+     */
+    static AbstractLogger::ErrorClass minimumErrorClass();
+
     /**
      * @brief Method for setting current logger.
+     * Previous logger is released, if it's not used
+     * by any `Reference`. Otherwise it's released,
+     * when last `Reference` unpins it.
      * @param logger Current logger.
      */
     static void setCurrentLogger(LoggerPtr logger);
@@ -45,6 +144,16 @@ private:
      */
     CurrentLogger();
 
-    static LoggerPtr m_logger;
+    /**
+     * @brief Method for releasing retired loggers,
+     * that are not pinned. Does nothing inside
+     * `Epoch::ReadGuard` section.
+     */
+    static void releaseRetired();
+
+    static std::atomic<AbstractLogger*> m_current;
+
+    // Count of retired loggers, checked on unpin
+    static std::atomic<std::size_t> m_retiredCount;
 };
 
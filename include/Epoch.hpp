@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Epoch based reclamation. Readers enter
+ * critical section with one store and load shared
+ * objects without locks. Replaced objects are
+ * deleted after all readers, that could see them,
+ * leave critical section.
+ */
+namespace Epoch
+{
+    /**
+     * @brief RAII object, that describes reader
+     * critical section. Sections can be nested.
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        /**
+         * @brief Constructor. Enters critical section.
+         */
+        ReadGuard();
+
+        /**
+         * @brief Destructor. Leaves critical section.
+         */
+        ~ReadGuard();
+    };
+
+    /**
+     * @brief Function for waiting all readers,
+     * that are inside critical section at the
+     * moment of call. Has to be called outside of
+     * critical section.
+     */
+    void synchronize();
+
+    /**
+     * @brief Function for checking is current
+     * thread inside critical section.
+     * @return Is inside critical section.
+     */
+    bool isReading();
+
+    /**
+     * @brief Class, that holds immutable value,
+     * that can be replaced at runtime while other
+     * threads are reading it.
+     * @tparam T Value type.
+     */
+    template<typename T>
+    class Atomic
+    {
+    public:
+        Atomic(const Atomic&) = delete;
+        Atomic& operator=(const Atomic&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @param value Initial value.
+         */
+        explicit Atomic(T value = T()) :
+            m_value(new T(std::move(value))),
+            m_writeMutex(),
+            m_retired()
+        {
+
+        }
+
+        /**
+         * @brief Destructor.
+         */
+        ~Atomic()
+        {
+            delete m_value.load();
+        }
+
+        /**
+         * @brief Method for getting current value.
+         * Has to be called inside `ReadGuard` section,
+         * result is valid until section end.
+         * @return Pointer to value.
+         */
+        const T* load() const
+        {
+            return m_value.load();
+        }
+
+        /**
+         * @brief Method for getting copy of
+         * current value.
+         * @return Value.
+         */
+        T get() const
+        {
+            ReadGuard guard;
+
+            return *load();
+        }
+
+        /**
+         * @brief Method for replacing value.
+         * @param value New value.
+         */
+        void store(T value)
+        {
+            std::unique_lock<std::mutex> lock(m_writeMutex);
+
+            replace(std::make_unique<T>(std::move(value)));
+        }
+
+        /**
+         * @brief Method for replacing value with
+         * modified copy of current one. Modifications
+         * are serialized.
+         * @param modifier Callable, that receives `T&`.
+         */
+        template<typename Modifier>
+        void update(Modifier&& modifier)
+        {
+            std::unique_lock<std::mutex> lock(m_writeMutex);
+
+            auto value = std::make_unique<T>(*m_value.load());
+
+            modifier(*value);
+
+            replace(std::move(value));
+        }
+
+    private:
+        void replace(std::unique_ptr<T> value)
+        {
+            m_retired.emplace_back(m_value.exchange(value.release()));
+
+            // Value can't be deleted from reader section,
+            // it will be deleted on next replace
+            if (isReading())
+            {
+                return;
+            }
+
+            synchronize();
+
+            m_retired.clear();
+        }
+
+        std::atomic<T*> m_value;
+
+        std::mutex m_writeMutex;
+        std::vector<std::unique_ptr<T>> m_retired;
+    };
+}
+
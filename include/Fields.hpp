@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Logger
+{
+    /**
+     * @brief Struct, that describes typed key-value
+     * field of message. Value is stored without
+     * formatting, it's serialized by formatter.
+     */
+    struct Field
+    {
+        enum class Type
+        {
+            Int
+            , UInt
+            , Double
+            , Bool
+            , String
+        };
+
+        /**
+         * @brief Default constructor.
+         */
+        Field() :
+            key(),
+            type(Type::Int),
+            intValue(0),
+            string()
+        {}
+
+        std::string key;
+        Type type;
+
+        union
+        {
+            int64_t intValue;
+            uint64_t uintValue;
+            double doubleValue;
+            bool boolValue;
+        };
+
+        // Value of `Type::String` fields
+        std::string string;
+    };
+
+    using Fields = std::vector<Field>;
+
+    /**
+     * @brief Key-value pair, that's created by
+     * `Logger::kv` and added to message by logger stream.
+     * @tparam T Value type.
+     */
+    template<typename T>
+    struct KeyValue
+    {
+        std::string_view key;
+        const T& value;
+    };
+
+    /**
+     * @brief Function for creating field, that
+     * can be passed to logger stream.
+     * Example: `Info() << Logger::kv("user", id) << "login";`
+     * @param key Field key.
+     * @param value Field value.
+     * @return Key-value pair.
+     */
+    template<typename T>
+    KeyValue<T> kv(std::string_view key, const T& value)
+    {
+        return {key, value};
+    }
+
+    /**
+     * @brief Function for creating field
+     * object from value. Arithmetic values are
+     * stored as is, strings are copied, other types
+     * are formatted with stream operator.
+     * @param key Field key.
+     * @param value Field value.
+     * @return Field.
+     */
+    template<typename T>
+    Field makeField(std::string_view key, const T& value)
+    {
+        Field field;
+        field.key = key;
+
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            field.type = Field::Type::Bool;
+            field.boolValue = value;
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            field.type = Field::Type::Int;
+            field.intValue = value;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            field.type = Field::Type::UInt;
+            field.uintValue = value;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            field.type = Field::Type::Double;
+            field.doubleValue = value;
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            field.type = Field::Type::String;
+            field.string = std::string_view(value);
+        }
+        else
+        {
+            std::ostringstream ss;
+            ss << value;
+
+            field.type = Field::Type::String;
+            field.string = ss.str();
+        }
+
+        return field;
+    }
+
+    /**
+     * @brief Function for adding field to
+     * logger stream. If stream is not logger
+     * stream, field is written as `key=value`.
+     * @param stream Output stream.
+     * @param field Field.
+     */
+    void addField(std::ostream& stream, Field field);
+
+    /**
+     * @brief Operator for adding key-value
+     * pair to logger stream.
+     * @param stream Output stream.
+     * @param keyValue Key-value pair.
+     * @return Output stream.
+     */
+    template<typename T>
+    std::ostream& operator<<(std::ostream& stream, const KeyValue<T>& keyValue)
+    {
+        addField(stream, makeField(keyValue.key, keyValue.value));
+
+        return stream;
+    }
+
+    /**
+     * @brief Function for appending fields
+     * as `key=value` pairs, separated by space.
+     * @param result Result string.
+     * @param fields Fields.
+     */
+    void appendFields(std::string& result, const Fields& fields);
+}
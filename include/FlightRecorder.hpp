@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Global in-memory flight recorder.
+     * Messages, that are below output level, are
+     * stored in fixed size per thread rings in
+     * binary form, without formatting and allocations.
+     * When message with trigger error class (or explicit
+     * trigger) is logged, last history is written to
+     * sinks before it. Recording thread does not take
+     * any locks, so recorder can be enabled permanently.
+     */
+    class FlightRecorder
+    {
+    public:
+        // Number of messages, that's kept for every thread
+        static constexpr std::size_t RingCapacity = 512;
+
+        // Maximum size of context and message text of
+        // recorded message. Longer text is truncated.
+        static constexpr std::size_t RecordTextSize = 224;
+
+        /**
+         * @brief Method for enabling recorder.
+         * Disabled by default.
+         * @param enabled Is recorder enabled.
+         */
+        static void setEnabled(bool enabled);
+
+        /**
+         * @brief Method for checking is recorder enabled.
+         * @return Is recorder enabled.
+         */
+        static bool isEnabled()
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Method for setting minimum error
+         * class of recorded messages. Default value is `Debug`.
+         * @param errorClass Error class.
+         */
+        static void setLevel(AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for getting minimum error
+         * class of recorded messages.
+         * @return Error class.
+         */
+        static AbstractLogger::ErrorClass level();
+
+        /**
+         * @brief Method for setting error class,
+         * that triggers history output. Default
+         * value is `Error`.
+         * @param errorClass Error class.
+         */
+        static void setTriggerLevel(AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for getting error class,
+         * that triggers history output.
+         * @return Error class.
+         */
+        static AbstractLogger::ErrorClass triggerLevel();
+
+        /**
+         * @brief Method for setting age of messages,
+         * that are written on trigger. Default value
+         * is 10 seconds.
+         * @param history Maximum message age.
+         */
+        static void setHistory(std::chrono::milliseconds history);
+
+        /**
+         * @brief Method for getting age of messages,
+         * that are written on trigger.
+         * @return Maximum message age.
+         */
+        static std::chrono::milliseconds history();
+
+        /**
+         * @brief Method for recording message into
+         * ring of current thread. Wait free.
+         * @param errorClass Message error class.
+         * @param filename Source filename.
+         * @param line Source line.
+         * @param thread Thread id.
+         * @param classname Class name.
+         * @param function Function name.
+         * @param message Message text.
+         */
+        static void record(AbstractLogger::ErrorClass errorClass,
+                           const char* filename,
+                           int line,
+                           std::thread::id thread,
+                           std::string_view classname,
+                           const char* function,
+                           std::string_view message);
+
+        /**
+         * @brief Method for taking recorded messages,
+         * that are not older than history and were not
+         * taken before. Messages are sorted by time.
+         * @param messages Result messages.
+         */
+        static void takeHistory(std::vector<AbstractLogger::Message>& messages);
+
+    private:
+        static std::atomic_bool m_enabled;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Formatters
+{
+    class AbstractFormatter;
+
+    using FormatterPtr = std::shared_ptr<AbstractFormatter>;
+
+    /**
+     * @brief Class, that describes
+     * abstract message formatter. Formatters
+     * are immutable, so one formatter can be used
+     * by several sinks and threads simultaneously.
+     */
+    class AbstractFormatter
+    {
+    public:
+
+        /**
+         * @brief Virtual destructor.
+         */
+        virtual ~AbstractFormatter() = default;
+
+        /**
+         * @brief Method for transforming message object
+         * to string.
+         * @param message Message object.
+         * @return Formatted log string.
+         */
+        virtual std::string format(const AbstractLogger::Message& message) const = 0;
+
+        /**
+         * @brief Method for checking is other formatter
+         * produces same output as this one. Logger formats
+         * message only once for all sinks with equivalent
+         * formatters.
+         * @param other Other formatter.
+         * @return Is formatters equivalent.
+         */
+        virtual bool isEquivalent(const AbstractFormatter& other) const;
+    };
+}
+
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "AbstractFormatter.hpp"
+
+namespace Formatters
+{
+    /**
+     * @brief Formatter, that forms one Chrome Trace
+     * Event JSON object per message, without separators.
+     * Span of `Logger::TraceSpan` is complete event:
+     * {"name":"db.query","cat":"Class::method","ph":"X",
+     *  "ts":1577836800000000.000,"dur":1200.500,"pid":10,
+     *  "tid":1234,"args":{"file":"main.cpp","line":10}}
+     * Other messages are instant events with `"ph":"i"`
+     * and message level in arguments. Time is in
+     * microseconds since epoch.
+     */
+    class ChromeTraceFormatter : public AbstractFormatter
+    {
+    public:
+        /**
+         * @brief Method for transforming message
+         * object to trace event.
+         * @param message Message object.
+         * @return JSON string.
+         */
+        std::string format(const AbstractLogger::Message& message) const override;
+
+        /**
+         * @brief All Chrome Trace formatters are equivalent.
+         * @param other Other formatter.
+         * @return Is formatters equivalent.
+         */
+        bool isEquivalent(const AbstractFormatter& other) const override;
+
+        /**
+         * @brief Method for getting numeric thread
+         * id, that's written into `tid` of event.
+         * @param thread Thread id.
+         * @return Numeric id.
+         */
+        static uint32_t threadId(std::thread::id thread);
+
+        /**
+         * @brief Method for getting id of current
+         * process, that's written into `pid` of event.
+         * @return Process id.
+         */
+        static uint32_t processId();
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "AbstractFormatter.hpp"
+
+namespace Formatters
+{
+    /**
+     * @brief Formatter, that forms one JSON
+     * object per message, without line ending.
+     * Message is written directly into string,
+     * without building of document. Example:
+     * {"time":"2020-01-01T00:00:00.000Z","level":"Info",
+     *  "file":"main.cpp","line":10,"thread":"0x...",
+     *  "context":"Class::method","message":"login",
+     *  "fields":{"user":42}}
+     * `fields` object is written only if message has fields,
+     * `thread_name` - only if thread has name.
+     * Strings are sanitized, so output is always valid
+     * JSON with one object per line.
+     */
+    class JsonLinesFormatter : public AbstractFormatter
+    {
+    public:
+        /**
+         * @brief Method for transforming message
+         * object to JSON object.
+         * @param message Message object.
+         * @return JSON string.
+         */
+        std::string format(const AbstractLogger::Message& message) const override;
+
+        /**
+         * @brief All JSON Lines formatters are equivalent.
+         * @param other Other formatter.
+         * @return Is formatters equivalent.
+         */
+        bool isEquivalent(const AbstractFormatter& other) const override;
+
+        /**
+         * @brief Method for appending JSON string
+         * with escaping and UTF-8 validation.
+         * @param result Result string.
+         * @param value String value.
+         */
+        static void appendString(std::string& result, std::string_view value);
+    };
+}
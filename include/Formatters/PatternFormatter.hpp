@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <string_view>
+#include "AbstractFormatter.hpp"
+
+namespace Formatters
+{
+    /**
+     * @brief Formatter, that forms message
+     * string by pattern.
+     * Possible fields:
+     * %{DATETIME}    - date and time info.
+     * %{FILENAME}    - source filename.
+     * %{LINE}        - source file line.
+     * %{THREAD}      - thread context.
+     * %{THREAD_NAME} - thread name, set by `Logger::Threads::setName`.
+     * %{CONTEXT}     - call context.
+     * %{ERROR_CLASS} - error class name.
+     * %{MESSAGE}     - error message
+     * %{FIELDS}      - key-value fields as `key=value` pairs.
+     */
+    class PatternFormatter : public AbstractFormatter
+    {
+    public:
+        PatternFormatter(const PatternFormatter&) = delete;
+        PatternFormatter& operator=(const PatternFormatter&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @param pattern Format string.
+         * @param sanitize Escape control characters and
+         * invalid UTF-8 in message, context and fields, so
+         * every message takes exactly one line.
+         */
+        explicit PatternFormatter(std::string pattern, bool sanitize = false);
+
+        /**
+         * @brief Method for getting format string.
+         * @return Format string.
+         */
+        const std::string& pattern() const;
+
+        /**
+         * @brief Method for checking is text sanitized.
+         * @return Is sanitization enabled.
+         */
+        bool sanitizationEnabled() const;
+
+        /**
+         * @brief Method for transforming message object
+         * to string, depending on format string.
+         * @param message Message object.
+         * @return Formatted log string.
+         */
+        std::string format(const AbstractLogger::Message& message) const override;
+
+        /**
+         * @brief Pattern formatters are equivalent if
+         * their format strings and sanitization are equal.
+         * @param other Other formatter.
+         * @return Is formatters equivalent.
+         */
+        bool isEquivalent(const AbstractFormatter& other) const override;
+
+    private:
+
+        /**
+         * @brief Method for caching
+         * current format string to
+         * optimize string forming.
+         */
+        void cacheFormat();
+
+        struct FormatCache
+        {
+            enum class Type
+            {
+                DateTime,
+                FileName,
+                Line,
+                Thread,
+                ThreadName,
+                Context,
+                ErrorClass,
+                Message,
+                Fields,
+                String
+            };
+
+            explicit FormatCache(Type type) :
+                type(type),
+                value()
+            {}
+
+            FormatCache(Type type, std::string_view view) :
+                type(type),
+                value(view)
+            {}
+
+            Type type;
+            std::string_view value;
+        };
+
+        /**
+         * @brief Method for writing text
+         * field to stream.
+         * @param ss Stream.
+         * @param text Text.
+         */
+        void writeText(std::ostream& ss, std::string_view text) const;
+
+        std::string m_formatString;
+        std::vector<FormatCache> m_formatCache;
+        bool m_sanitize;
+    };
+}
+
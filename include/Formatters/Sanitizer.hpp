@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Formatters
+{
+    /**
+     * @brief Class for escaping control characters
+     * and replacing invalid UTF-8 in message text.
+     * Clean runs are found with SSE2/AVX2 kernels
+     * (if available) and copied at once, so clean
+     * text costs almost only memory copy. AVX2 kernel
+     * also validates UTF-8, so valid non ASCII text is
+     * clean too. SSE2 and scalar kernels stop at non
+     * ASCII bytes, they are validated one by one.
+     */
+    class Sanitizer
+    {
+    public:
+        enum class Mode
+        {
+            Text    //< Control characters are escaped as `\n`, `\r` or `\xHH`. Invalid UTF-8 bytes are written as `\xHH`.
+            , Json  //< JSON string content. Quotes, backslashes and control characters are escaped, invalid UTF-8 is replaced with `�`.
+        };
+
+        /**
+         * @brief Method for appending sanitized text.
+         * @param result Result string.
+         * @param text Source text.
+         * @param mode Escaping mode.
+         */
+        static void append(std::string& result, std::string_view text, Mode mode);
+
+        /**
+         * @brief Method for finding first byte, that
+         * can require escaping: control characters,
+         * non ASCII bytes and, in JSON mode, quotes
+         * and backslashes. Kernel, that validates UTF-8,
+         * skips valid multi byte sequences.
+         * @param text Source text.
+         * @param mode Escaping mode.
+         * @return Position of byte or size of text.
+         */
+        static std::size_t findSpecial(std::string_view text, Mode mode);
+
+        /**
+         * @brief Method for enabling SIMD kernels.
+         * They are enabled by default, if CPU supports
+         * them. Used for testing of scalar fallback.
+         * @param enabled Is SIMD enabled.
+         */
+        static void setSimdEnabled(bool enabled);
+
+        /**
+         * @brief Method for getting name of
+         * kernel, that's used.
+         * @return "avx2", "sse2" or "scalar".
+         */
+        static const char* kernelName();
+    };
+}
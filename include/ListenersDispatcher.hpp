@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include "MessagesRing.hpp"
+#include "LogsListener.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Class, that delivers messages to logs
+     * listeners. Logging thread only pushes message
+     * into broadcast ring, and dedicated thread
+     * passes messages to every listener with it's
+     * own cursor. So slow listener never blocks
+     * logging thread. If listener is too slow, it
+     * will miss oldest messages.
+     */
+    class ListenersDispatcher
+    {
+    public:
+        ListenersDispatcher(const ListenersDispatcher&) = delete;
+        ListenersDispatcher& operator=(const ListenersDispatcher&) = delete;
+
+        /**
+         * @brief Constructor. Dispatching thread
+         * is started with first listener.
+         * @param capacity Ring capacity in messages.
+         */
+        explicit ListenersDispatcher(std::size_t capacity = 4096);
+
+        /**
+         * @brief Destructor. Stops dispatching thread.
+         */
+        ~ListenersDispatcher();
+
+        /**
+         * @brief Method for adding listener. Listener
+         * will receive messages, that are logged after
+         * this call. `BatchLogsListener` is attached to
+         * ring and pulls messages by itself. Thread safe.
+         * @param listener Listener.
+         */
+        void addListener(LogsListenerPtr listener);
+
+        /**
+         * @brief Method for removing listener. Listener
+         * can still receive messages, that are dispatched
+         * at the moment. Thread safe.
+         * @param listener Listener.
+         */
+        void removeListener(const LogsListenerPtr& listener);
+
+        /**
+         * @brief Method for checking is there any
+         * listeners. Cheap, can be called on every message.
+         * @return Is there any listeners.
+         */
+        bool hasListeners() const;
+
+        /**
+         * @brief Method for publishing message to
+         * listeners. Never waits for listeners.
+         * @param message Message.
+         */
+        void publish(const AbstractLogger::Message& message);
+
+        /**
+         * @brief Method for getting number of messages
+         * that was missed by listeners, because they were
+         * too slow.
+         * @return Number of messages.
+         */
+        uint64_t droppedMessages() const;
+
+    private:
+        struct Subscription
+        {
+            LogsListenerPtr listener;
+            uint64_t cursor;
+
+            // Listener reads ring by itself
+            bool pulling;
+        };
+
+        using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+        // Maximum number of messages, passed to one
+        // listener, before switching to next one
+        static constexpr std::size_t DispatchBatchSize = 256;
+
+        /**
+         * @brief Dispatching thread method.
+         */
+        void dispatchingThread();
+
+        std::shared_ptr<MessagesRing> m_ring;
+
+        std::vector<SubscriptionPtr> m_subscriptions;
+        std::atomic<std::size_t> m_listenersCount;
+        std::atomic<uint64_t> m_droppedMessages;
+
+        std::mutex m_mutex;
+        std::condition_variable m_variable;
+        std::atomic_bool m_sleeping;
+        bool m_working;
+        std::thread m_thread;
+    };
+}
+
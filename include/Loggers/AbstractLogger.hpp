@@ -8,6 +8,10 @@
 #include <sstream>
 #include <thread>
 #include <string_view>
+#include <atomic>
+#include "Clock.hpp"
+#include "Epoch.hpp"
+#include "Fields.hpp"
 
 #ifdef OS_LINUX
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
@@ -22,10 +26,27 @@ using LoggerPtr = std::shared_ptr<AbstractLogger>;
 namespace Logger
 {
     class LogsListener;
+    class ListenersDispatcher;
 
     using LogsListenerPtr = std::shared_ptr<LogsListener>;
 }
 
+namespace Formatters
+{
+    class AbstractFormatter;
+
+    using FormatterPtr = std::shared_ptr<AbstractFormatter>;
+}
+
+namespace Sinks
+{
+    class AbstractSink;
+    class TerminalSink;
+    class FileSink;
+
+    using SinkPtr = std::shared_ptr<AbstractSink>;
+}
+
 /**
  * @brief Class, that describes
  * abstract logger object.
@@ -54,18 +75,43 @@ public:
          * @brief Default constructor.
          */
         Message() :
+            timestamp(0),
             timePoint(),
             errorClass(ErrorClass::Unknown),
             message(),
             thread(),
             filename(nullptr),
             context(),
-            line(0)
+            line(0),
+            history(false),
+            span(false),
+            spanDuration(0),
+            fields(),
+            backtrace()
         {}
 
         Message(const Message&) = default;
         Message& operator=(const Message&) = default;
 
+        /**
+         * @brief Method for getting message wall time.
+         * Raw timestamp is converted, if it's set.
+         * @return Time point.
+         */
+        std::chrono::system_clock::time_point time() const
+        {
+            if (timestamp != 0)
+            {
+                return Logger::Clock::toTimePoint(timestamp);
+            }
+
+            return timePoint;
+        }
+
+        // Raw `Logger::Clock` value, taken at call site
+        uint64_t timestamp;
+
+        // Time of messages without raw timestamp
         std::chrono::system_clock::time_point timePoint;
         ErrorClass errorClass;
         std::string message;
@@ -73,6 +119,23 @@ public:
         const char* filename;
         std::string context;
         int line;
+
+        // Message is taken from flight recorder
+        bool history;
+
+        // Message is span of `Logger::TraceSpan`, it's
+        // passed only to sinks, that accept spans
+        bool span;
+
+        // Span duration in nanoseconds
+        uint64_t spanDuration;
+
+        // Typed key-value fields, added by `Logger::kv`
+        Logger::Fields fields;
+
+        // Raw return addresses, captured by
+        // `Logger::Backtrace`. Innermost first.
+        std::vector<void*> backtrace;
     };
 
     /**
@@ -81,9 +144,9 @@ public:
     AbstractLogger();
 
     /**
-     * @brief Defult destructor.
+     * @brief Virtual destructor.
      */
-    virtual ~AbstractLogger() = default;
+    virtual ~AbstractLogger();
 
     /**
      * @brief Method for putting some information into logger.
@@ -93,6 +156,9 @@ public:
      * @param classname Log context. For example class and method names or function name.
      * @param line Line in source code.
      * @param thread Callee thread id.
+     * @param fields Message key-value fields.
+     * @param timestamp Raw `Logger::Clock` timestamp. If it's
+     * 0, timestamp is taken by logger.
      */
     void log(AbstractLogger::ErrorClass errorClass,
              const char *filename,
@@ -100,7 +166,9 @@ public:
              std::thread::id thread,
              std::string classname,
              const char *function,
-             std::string message);
+             std::string message,
+             Logger::Fields fields = Logger::Fields(),
+             uint64_t timestamp = 0);
 
     /**
      * @brief Method for setting is truncation of
@@ -163,15 +231,18 @@ public:
 
     /**
      * @brief Method for setting format string for
-     * logger.
+     * logger. Format is used by all sinks, that
+     * has no own formatter.
      * Possible fields:
      * %{DATETIME}    - date and time info.
      * %{FILENAME}    - source filename.
      * %{LINE}        - source file line.
-     * ${THREAD}      - thread context.
+     * %{THREAD}      - thread context.
+     * %{THREAD_NAME} - thread name, set by `Logger::Threads::setName`.
      * %{CONTEXT}     - call context.
      * %{ERROR_CLASS} - error class name.
      * %{MESSAGE}     - error message
+     * %{FIELDS}      - key-value fields as `key=value` pairs.
      * @param format Format string.
      */
     void setFormat(std::string format);
@@ -179,27 +250,142 @@ public:
     /**
      * @brief Method for getting current format
      * string.
-     * @return Format string.
+     * @return Format string. Empty string if logger
+     * formatter is not pattern based.
      */
     std::string format() const;
 
+    /**
+     * @brief Method for setting logger formatter.
+     * Formatter is used by all sinks, that
+     * has no own formatter.
+     * @param formatter Formatter.
+     */
+    void setFormatter(Formatters::FormatterPtr formatter);
+
+    /**
+     * @brief Method for getting logger formatter.
+     * @return Formatter.
+     */
+    Formatters::FormatterPtr formatter() const;
+
+    /**
+     * @brief Method for adding sink to logger.
+     * Every message will be passed to every sink,
+     * that accepts message error class.
+     * @param sink Sink.
+     */
+    void addSink(Sinks::SinkPtr sink);
+
+    /**
+     * @brief Method for removing sink from logger.
+     * @param sink Sink.
+     */
+    void removeSink(const Sinks::SinkPtr& sink);
+
+    /**
+     * @brief Method for getting logger sinks.
+     * @return Sinks.
+     */
+    std::vector<Sinks::SinkPtr> sinks() const;
+
+    /**
+     * @brief Method for getting default terminal
+     * sink, that's created by logger.
+     * @return Terminal sink.
+     */
+    std::shared_ptr<Sinks::TerminalSink> terminalSink() const;
+
+    /**
+     * @brief Method for getting default file
+     * sink, that's created by logger.
+     * @return File sink.
+     */
+    std::shared_ptr<Sinks::FileSink> fileSink() const;
+
+    /**
+     * @brief Method for replacing default file
+     * sink. For example with `Sinks::MappedFileSink`.
+     * Logger file settings will be applied to new sink.
+     * @param sink File sink.
+     */
+    void setFileSink(std::shared_ptr<Sinks::FileSink> sink);
+
+    /**
+     * @brief Method for passing span of `Logger::TraceSpan`
+     * to sinks, that accept spans. Span is not passed to
+     * other sinks and logs listeners. Span message is built
+     * only if there is such sink.
+     * @param filename Filename.
+     * @param line Line in source code.
+     * @param thread Thread id.
+     * @param function Function name.
+     * @param name Span name.
+     * @param begin Raw `Logger::Clock` timestamp of span begin.
+     * @param duration Span duration in nanoseconds.
+     */
+    void logSpan(const char* filename,
+                 int line,
+                 std::thread::id thread,
+                 const char* function,
+                 std::string_view name,
+                 uint64_t begin,
+                 uint64_t duration);
+
+    /**
+     * @brief Method for checking is any
+     * sink accepts spans.
+     * @return Are spans accepted.
+     */
+    bool acceptsSpans() const;
+
+    /**
+     * @brief Method for getting minimum error class
+     * of messages, that logger can use. It's used by
+     * call sites of logging macros to skip messages
+     * before stream creation.
+     * @return Error class.
+     */
+    virtual ErrorClass minimumAcceptedErrorClass() const;
+
     /**
      * @brief Method for adding log listener.
+     * Messages are passed to listeners from
+     * dedicated thread, so slow listener does
+     * not slow down logging. Thread safe.
      * @param listener Listener.
      */
     void addLogsListener(Logger::LogsListenerPtr listener);
 
     /**
      * @brief Method for removing logs listener.
+     * Thread safe.
      * @param listener Listener.
      */
     void removeLogsListener(Logger::LogsListenerPtr listener);
 
+    /**
+     * @brief Method for writing flight recorder
+     * history, that was not written yet. It's
+     * called automatically on message with recorder
+     * trigger error class. History is passed to sinks,
+     * that accept trigger error class.
+     */
+    void triggerFlightRecorder();
+
     /**
      * @brief Method for waiting logs to be written.
      */
     virtual void waitForLogToBeWritten();
 
+    /**
+     * @brief Method for waiting logs to be written
+     * and stored durably by all sinks. For example
+     * file sinks sync log files to disk.
+     * @return Are logs stored durably by all sinks.
+     */
+    bool waitForLogToBeDurable();
+
     /**
      * @brief Method for setting maximum log
      * file size in bytes. If log file
@@ -220,6 +406,17 @@ public:
 
 protected:
 
+    /**
+     * @brief Formatted representations of message.
+     * One string for every group of equivalent formatters.
+     */
+    using FormattedStrings = std::vector<
+        std::pair<
+            Formatters::FormatterPtr,
+            std::string
+        >
+    >;
+
     /**
      * @brief Method that's called on new log message after
      * some basic processing.
@@ -230,76 +427,109 @@ protected:
     /**
      * @brief Method for transforming message object
      * to string, depending on format string.
+     * Can be called from several threads at once.
      * @param message Message object.
      * @return Formatted log string.
-     * @todo Can be optimized to O(n).
      */
     std::string messageToString(const Message& message);
 
     /**
-     * @brief Method for getting log file path, using
-     * log file rotation.
-     * @return
+     * @brief Method for checking is any sink
+     * accepts message with specified error class.
+     * @param errorClass Error class.
+     * @return Is message accepted by any sink.
      */
-    std::string getLogPath() const;
+    bool isAccepted(ErrorClass errorClass) const;
 
-private:
+    /**
+     * @brief Method for getting minimum error class
+     * of messages, that are used without sinks: by
+     * logs listeners and flight recorder trigger.
+     * @return Error class.
+     */
+    ErrorClass minimumListenedErrorClass() const;
 
     /**
-     * @brief Method for caching
-     * current format string to
-     * optimize string forming.
+     * @brief Method for checking is any sink
+     * accepts message. Flight recorder history is
+     * checked with recorder trigger error class.
+     * @param message Message object.
+     * @return Is message accepted by any sink.
      */
-    void cacheFormat();
+    bool isAccepted(const Message& message) const;
 
-    struct FormatCache
-    {
-        /*
-         * %{DATETIME}    - date and time info.
-         * %{FILENAME}    - source filename.
-         * %{LINE}        - source file line.
-         * ${THREAD}      - thread context.
-         * %{CONTEXT}     - call context.
-         * %{ERROR_CLASS} - error class name.
-         * %{MESSAGE}     - error message
-         */
-        enum class Type
-        {
-            DateTime,
-            FileName,
-            Line,
-            Thread,
-            Context,
-            ErrorClass,
-            Message,
-            String
-        };
-
-        explicit FormatCache(Type type) :
-            type(type),
-            value()
-        {}
+    /**
+     * @brief Method for formatting message for all
+     * sinks, that accepts it. Message is formatted only
+     * once for sinks with equivalent formatters.
+     * Can be called from several threads at once.
+     * @param message Message object.
+     * @param strings Result formatted strings.
+     */
+    void formatMessage(const Message& message, FormattedStrings& strings) const;
 
-        FormatCache(Type type, std::string_view view) :
-            type(type),
-            value(view)
-        {}
+    /**
+     * @brief Method for writing formatted message
+     * to all sinks, that accepts it.
+     * @param message Message object.
+     * @param strings Strings, formatted by `formatMessage`.
+     */
+    void writeMessage(const Message& message, const FormattedStrings& strings);
+
+    /**
+     * @brief Method for finishing batch of
+     * messages on all sinks.
+     */
+    void commitSinks();
 
-        Type type;
-        std::string_view value;
+private:
+    friend class CurrentLogger;
+
+    /**
+     * @brief Counter of references, that use logger
+     * as current one. It's sharded by threads, so
+     * references from different threads don't share
+     * cache line.
+     */
+    struct alignas(64) PinCounter
+    {
+        std::atomic<int64_t> value{0};
     };
 
+    static constexpr std::size_t PinCountersCount = 16;
+
+    /**
+     * @brief Struct, that describes logger
+     * configuration. It's immutable, every
+     * change replaces whole snapshot.
+     */
+    struct Configuration;
+
+    /**
+     * @brief Method for getting formatter, that
+     * has to be used for sink.
+     * @param configuration Logger configuration.
+     * @param sink Sink.
+     * @return Formatter.
+     */
+    static Formatters::FormatterPtr sinkFormatter(const Configuration& configuration,
+                                                  const Sinks::SinkPtr& sink);
+
+    /**
+     * @brief Method for checking is message
+     * accepted by sink.
+     * @param sink Sink.
+     * @param message Message object.
+     * @return Is message accepted.
+     */
+    static bool sinkAccepts(const Sinks::SinkPtr& sink, const Message& message);
+
     std::string classPlusFunction(std::string classname, const char* function);
 
-    std::vector<Logger::LogsListenerPtr> m_logsListeners;
+    std::unique_ptr<Logger::ListenersDispatcher> m_listenersDispatcher;
 
-    uint64_t m_maxLogFileSizeBytes;
-    std::string m_formatString;
-    std::vector<FormatCache> m_formatCache;
-    std::string m_fileLogPath;
-    bool m_sourceFilenameTruncationEnabled;
-    ErrorClass m_minTerminalOutputErrorClass;
-    ErrorClass m_minFileOutputErrorClass;
-    std::stringstream m_ss;
-};
+    Epoch::Atomic<Configuration> m_configuration;
+    std::atomic_bool m_sourceFilenameTruncationEnabled;
 
+    PinCounter m_pins[PinCountersCount];
+};
@@ -1,23 +1,37 @@
 #pragma once
 
 #include <thread>
-#include <queue>
+#include <atomic>
+#include <map>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #include "AbstractLogger.hpp"
+#include "RecordQueue.hpp"
 
 namespace Loggers
 {
     /**
-     * @brief Async logger instance.
+     * @brief Async logger instance. Messages are
+     * passed to writing thread through lock free
+     * bounded queue of packed messages. If queue
+     * is full, logging thread waits for free space.
      */
     class AsyncLogger : public AbstractLogger
     {
     public:
         /**
          * @brief Constructor.
+         * @param formattingThreads Number of threads, that will
+         * format messages in parallel. Formatted messages are
+         * still written in original order. If value is 0 -
+         * messages will be formatted by writing thread.
+         * @param queueCapacity Size of queue in 64 byte
+         * blocks. Message takes one block for every 52
+         * bytes of header (48 bytes) and text.
          */
-        AsyncLogger();
+        explicit AsyncLogger(std::size_t formattingThreads = 0,
+                             std::size_t queueCapacity = 16384);
 
         /**
          * @brief Virtual destructor.
@@ -30,18 +44,112 @@ namespace Loggers
          */
         void waitForLogToBeWritten() override;
 
+        /**
+         * @brief Method for getting number of
+         * formatting threads.
+         * @return Number of threads.
+         */
+        std::size_t formattingThreads() const;
+
+        /**
+         * @brief Method for enabling crash handler.
+         * On SIGSEGV, SIGABRT, SIGBUS, SIGFPE and SIGILL
+         * it writes messages, that are still in queue,
+         * directly to current log file and stderr,
+         * appends marker line and raises signal again.
+         * Messages, that are already taken by formatting
+         * threads, are lost. There are no more than
+         * few batches of them per thread.
+         * Only one logger can have crash handler.
+         * Log file path is taken at the moment of call.
+         * Available only on Linux.
+         * @param enabled Is crash handler enabled.
+         */
+        void setCrashHandlerEnabled(bool enabled);
+
+        /**
+         * @brief Method for checking is crash
+         * handler enabled for this logger.
+         * @return Is crash handler enabled.
+         */
+        bool crashHandlerEnabled() const;
+
     protected:
         void onNewMessage(const Message& message) override;
 
     private:
+        /**
+         * @brief Maximum number of messages, that
+         * formatting thread takes from queue at once.
+         */
+        static constexpr std::size_t FormattingBatchSize = 64;
+
+        /**
+         * @brief Maximum number of formatted batches per
+         * formatting thread, that wait for writer. If writer
+         * stalls, messages stay in bounded queue, so logging
+         * threads wait and crash handler can flush them.
+         */
+        static constexpr std::size_t ReorderedBatchesPerThread = 4;
+
+        /**
+         * @brief Formatted message, that is
+         * waiting for it's turn to be written.
+         */
+        struct FormattedMessage
+        {
+            Message message;
+            FormattedStrings strings;
+
+            // Number of queue blocks of message
+            uint64_t blocks;
+        };
 
         void mainThread();
 
-        bool m_working;
+        void formattingThread();
+
+        void writerThread();
+
+        /**
+         * @brief Method for waiting new messages
+         * in queue.
+         */
+        void waitForMessages();
+
+        /**
+         * @brief Signal handler, that flushes
+         * queue of logger with crash handler.
+         * @param signal Signal number.
+         */
+        static void crashHandler(int signal);
+
+        /**
+         * @brief Method for writing queued messages
+         * without locks and allocations.
+         * @param fds File descriptors.
+         * @param count Number of file descriptors.
+         * @param signal Signal number.
+         */
+        void emergencyFlush(const int* fds, std::size_t count, int signal) const;
+
+        std::atomic_bool m_working;
         std::thread m_mainThread;
+        std::vector<std::thread> m_formattingThreads;
+        std::size_t m_formattingThreadsCount;
 
-        std::queue<Message> m_messages;
+        Logger::RecordQueue m_messages;
         std::mutex m_messagesMutex;
+        std::atomic<std::size_t> m_sleepingThreads;
+
+        // Queue position of next message, that has to be written.
+        std::atomic<uint64_t> m_writtenSequence;
+
+        // Formatted batches by position of first message.
+        std::map<uint64_t, std::vector<FormattedMessage>> m_reorderBuffer;
+        std::mutex m_reorderMutex;
+        std::condition_variable m_reorderVariable;
+        std::condition_variable m_reorderSpaceVariable;
 
         std::condition_variable m_cond;
         std::condition_variable m_clearVariable;
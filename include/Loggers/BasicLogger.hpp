@@ -1,8 +1,6 @@
 #pragma once
 
 
-#include <fstream>
-#include <mutex>
 #include "AbstractLogger.hpp"
 
 namespace Loggers
@@ -21,15 +19,9 @@ namespace Loggers
     protected:
         /**
          * @brief On new message, this logger, synchronous writes
-         * to terminal and/or file.
+         * to all sinks.
          * @param message Message object.
          */
         void onNewMessage(const Message& message) override;
-
-    private:
-        std::ofstream m_outputFile;
-
-        std::mutex m_fileMutex;
-        std::mutex m_terminalMutex;
     };
 }
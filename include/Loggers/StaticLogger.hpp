@@ -0,0 +1,479 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include "AbstractLogger.hpp"
+#include "Clock.hpp"
+#include "RecordQueue.hpp"
+
+namespace Loggers
+{
+    /**
+     * @brief Queue policy, that processes message
+     * in calling thread. Sink policies has to be
+     * thread safe.
+     * @tparam Handler Logger type.
+     */
+    template<typename Handler>
+    class DirectQueue
+    {
+    public:
+        DirectQueue(const DirectQueue&) = delete;
+        DirectQueue& operator=(const DirectQueue&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @param handler Logger, that processes messages.
+         */
+        explicit DirectQueue(Handler& handler) :
+            m_handler(handler)
+        {}
+
+        /**
+         * @brief Method for passing message to logger.
+         * @param message Message object.
+         */
+        void push(const AbstractLogger::Message& message)
+        {
+            m_handler.process(message);
+            m_handler.commit();
+        }
+
+        /**
+         * @brief Method for waiting messages to be
+         * written. Messages are written on push.
+         */
+        void wait()
+        {}
+
+    private:
+        Handler& m_handler;
+    };
+
+    /**
+     * @brief Queue policy, that passes packed
+     * messages to one writing thread through
+     * `Logger::RecordQueue`. Sinks are called only
+     * from writing thread.
+     * @tparam Handler Logger type.
+     */
+    template<typename Handler>
+    class AsyncQueue
+    {
+    public:
+        AsyncQueue(const AsyncQueue&) = delete;
+        AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+        // Size of queue in blocks
+        static constexpr std::size_t QueueBlocks = 16384;
+
+        /**
+         * @brief Constructor. Starts writing thread.
+         * @param handler Logger, that processes messages.
+         */
+        explicit AsyncQueue(Handler& handler) :
+            m_handler(handler),
+            m_queue(QueueBlocks),
+            m_working(true),
+            m_sleeping(false),
+            m_written(0),
+            m_mutex(),
+            m_messagesVariable(),
+            m_writtenVariable(),
+            m_thread(&AsyncQueue::run, this)
+        {}
+
+        /**
+         * @brief Destructor. Writes rest of messages
+         * and stops writing thread.
+         */
+        ~AsyncQueue()
+        {
+            wait();
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_working = false;
+            }
+
+            m_messagesVariable.notify_all();
+
+            m_thread.join();
+        }
+
+        /**
+         * @brief Method for passing message to
+         * writing thread. Waits, if queue is full.
+         * @param message Message object.
+         */
+        void push(const AbstractLogger::Message& message)
+        {
+            while (!m_queue.tryPush(message))
+            {
+                wake();
+                std::this_thread::yield();
+            }
+
+            // Pairs with fence in `run`
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (m_sleeping.load(std::memory_order_relaxed))
+            {
+                wake();
+            }
+        }
+
+        /**
+         * @brief Method for waiting messages, that
+         * were pushed before call, to be written.
+         */
+        void wait()
+        {
+            auto pushed = m_queue.pushPosition();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (m_written < pushed)
+            {
+                m_writtenVariable.wait(lock);
+            }
+        }
+
+    private:
+        void wake()
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+            }
+
+            m_messagesVariable.notify_one();
+        }
+
+        void run()
+        {
+            AbstractLogger::Message message;
+            uint64_t position = 0;
+            uint64_t blocks = 0;
+
+            while (true)
+            {
+                uint64_t written = m_written;
+
+                while (m_queue.tryPop(message, position, blocks))
+                {
+                    m_handler.process(message);
+
+                    written = position + blocks;
+                }
+
+                if (written != m_written)
+                {
+                    m_handler.commit();
+
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_written = written;
+                    }
+
+                    m_writtenVariable.notify_all();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                if (!m_working)
+                {
+                    break;
+                }
+
+                m_sleeping = true;
+
+                // Pairs with fence in `push`
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (m_queue.empty())
+                {
+                    m_messagesVariable.wait_for(lock, std::chrono::milliseconds(100));
+                }
+
+                m_sleeping = false;
+            }
+        }
+
+        Handler& m_handler;
+        Logger::RecordQueue m_queue;
+        bool m_working;
+        std::atomic_bool m_sleeping;
+        uint64_t m_written;
+        std::mutex m_mutex;
+        std::condition_variable m_messagesVariable;
+        std::condition_variable m_writtenVariable;
+        std::thread m_thread;
+    };
+
+    /**
+     * @brief Logger, that's composed from policies
+     * at compile time. There are no virtual calls
+     * and shared pointers on message path, so
+     * compiler can inline it completely.
+     *
+     * Policies:
+     * QueuePolicy  - `DirectQueue` or `AsyncQueue`, or
+     * other template with `push(message)` and `wait()`.
+     * FormatPolicy - formatter type, for example
+     * `Formatters::JsonLinesFormatter`. It's called without
+     * virtual dispatch.
+     * SinkPolicies - sink types with `accepts(errorClass)`,
+     * `write(message, formatted)` and `commit()`. For example
+     * `Sinks::TerminalSink`. Every sink is stored by value.
+     *
+     * Use `StaticLoggerAdapter` to set it as current logger.
+     */
+    template<template<typename> class QueuePolicy, typename FormatPolicy, typename... SinkPolicies>
+    class StaticLogger
+    {
+    public:
+        StaticLogger(const StaticLogger&) = delete;
+        StaticLogger& operator=(const StaticLogger&) = delete;
+
+        /**
+         * @brief Constructor. Sinks are default constructed.
+         * @param args Formatter constructor arguments.
+         */
+        template<typename... FormatArgs>
+        explicit StaticLogger(FormatArgs&&... args) :
+            m_format(std::forward<FormatArgs>(args)...),
+            m_sinks(),
+            m_queue(*this)
+        {}
+
+        /**
+         * @brief Method for putting some information into logger.
+         * @param errorClass Log error class enum value.
+         * @param filename Filename.
+         * @param line Line in source code.
+         * @param thread Callee thread id.
+         * @param classname Class name.
+         * @param function Function name.
+         * @param message Log message.
+         */
+        void log(AbstractLogger::ErrorClass errorClass,
+                 const char* filename,
+                 int line,
+                 std::thread::id thread,
+                 std::string_view classname,
+                 const char* function,
+                 std::string_view message)
+        {
+            if (!isAccepted(errorClass))
+            {
+                return;
+            }
+
+            // Strings of message are reused
+            static thread_local AbstractLogger::Message messageObject;
+
+            messageObject.timestamp = Logger::Clock::now();
+            messageObject.errorClass = errorClass;
+            messageObject.filename = filename;
+            messageObject.line = line;
+            messageObject.thread = thread;
+            messageObject.context.assign(classname);
+
+            if (!classname.empty())
+            {
+                messageObject.context.append("::");
+            }
+
+            messageObject.context.append(function);
+            messageObject.message.assign(message);
+
+            m_queue.push(messageObject);
+        }
+
+        /**
+         * @brief Method for putting message into
+         * logger. Message is dropped, if no sink
+         * accepts it.
+         * @param message Message object.
+         */
+        void push(const AbstractLogger::Message& message)
+        {
+            if (isAccepted(message.errorClass))
+            {
+                m_queue.push(message);
+            }
+        }
+
+        /**
+         * @brief Method for checking is any sink
+         * accepts message with specified error class.
+         * @param errorClass Error class.
+         * @return Is message accepted.
+         */
+        bool isAccepted(AbstractLogger::ErrorClass errorClass) const
+        {
+            return std::apply(
+                [errorClass](const SinkPolicies&... sinks)
+                {
+                    return (sinks.accepts(errorClass) || ...);
+                },
+                m_sinks
+            );
+        }
+
+        /**
+         * @brief Method for waiting logs to be written.
+         */
+        void waitForLogToBeWritten()
+        {
+            m_queue.wait();
+        }
+
+        /**
+         * @brief Method for getting formatter.
+         * @return Formatter.
+         */
+        FormatPolicy& formatter()
+        {
+            return m_format;
+        }
+
+        /**
+         * @brief Method for getting sink.
+         * @tparam Index Sink index in policies.
+         * @return Sink.
+         */
+        template<std::size_t Index>
+        auto& sink()
+        {
+            return std::get<Index>(m_sinks);
+        }
+
+        /**
+         * @brief Method for formatting message and
+         * writing it to accepting sinks. It's called
+         * by queue policy.
+         * @param message Message object.
+         */
+        void process(const AbstractLogger::Message& message)
+        {
+            // Qualified call is not virtual
+            auto formatted = m_format.FormatPolicy::format(message);
+
+            std::apply(
+                [&message, &formatted](SinkPolicies&... sinks)
+                {
+                    ((sinks.accepts(message.errorClass) ? sinks.write(message, formatted) : void()), ...);
+                },
+                m_sinks
+            );
+        }
+
+        /**
+         * @brief Method for finishing batch of messages
+         * on all sinks. It's called by queue policy.
+         */
+        void commit()
+        {
+            std::apply(
+                [](SinkPolicies&... sinks)
+                {
+                    (sinks.commit(), ...);
+                },
+                m_sinks
+            );
+        }
+
+    private:
+        FormatPolicy m_format;
+        std::tuple<SinkPolicies...> m_sinks;
+
+        // Queue is destroyed first, so it
+        // can write rest of messages
+        QueuePolicy<StaticLogger> m_queue;
+    };
+
+    /**
+     * @brief Adapter, that makes `StaticLogger`
+     * usable as `AbstractLogger`, for example with
+     * `CurrentLogger` and logging macros. Messages are
+     * passed to static logger instead of logger sinks.
+     * @tparam StaticLoggerType `StaticLogger` type.
+     */
+    template<typename StaticLoggerType>
+    class StaticLoggerAdapter : public AbstractLogger
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param args `StaticLogger` constructor arguments.
+         */
+        template<typename... Args>
+        explicit StaticLoggerAdapter(Args&&... args) :
+            m_logger(std::forward<Args>(args)...)
+        {}
+
+        /**
+         * @brief Method for getting static logger.
+         * @return Logger.
+         */
+        StaticLoggerType& logger()
+        {
+            return m_logger;
+        }
+
+        /**
+         * @brief Method for waiting logs to be written.
+         */
+        void waitForLogToBeWritten() override
+        {
+            m_logger.waitForLogToBeWritten();
+        }
+
+        /**
+         * @brief Method for getting minimum error class
+         * of messages, that static logger sinks accept.
+         * @return Error class.
+         */
+        ErrorClass minimumAcceptedErrorClass() const override
+        {
+            auto result = minimumListenedErrorClass();
+
+            for (auto errorClass : {ErrorClass::Unknown,
+                                    ErrorClass::Debug,
+                                    ErrorClass::Info,
+                                    ErrorClass::Warning,
+                                    ErrorClass::Error})
+            {
+                if (errorClass < result && m_logger.isAccepted(errorClass))
+                {
+                    return errorClass;
+                }
+            }
+
+            return result;
+        }
+
+    protected:
+        void onNewMessage(const Message& message) override
+        {
+            // Static sinks don't take spans
+            if (message.span)
+            {
+                return;
+            }
+
+            m_logger.push(message);
+        }
+
+    private:
+        StaticLoggerType m_logger;
+    };
+}
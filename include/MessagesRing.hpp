@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Fixed size broadcast ring of messages.
+     * Any number of threads can push messages, while
+     * every reader has it's own cursor. Writers never
+     * wait for readers: if reader is too slow, oldest
+     * messages are overwritten and skipped by reader.
+     * Messages are copied into preallocated slot objects,
+     * so pushing doesn't allocate, if readers don't
+     * hold overwritten message.
+     */
+    class MessagesRing
+    {
+    public:
+        using MessagePtr = std::shared_ptr<const AbstractLogger::Message>;
+
+        MessagesRing(const MessagesRing&) = delete;
+        MessagesRing& operator=(const MessagesRing&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @param capacity Number of messages in ring.
+         * Will be rounded up to power of two.
+         */
+        explicit MessagesRing(std::size_t capacity);
+
+        /**
+         * @brief Method for copying message into ring.
+         * Raw timestamp is converted to wall time, so
+         * readers get `timePoint` only. Thread safe.
+         * @param message Message.
+         */
+        void push(const AbstractLogger::Message& message);
+
+        /**
+         * @brief Method for getting sequence number
+         * of next pushed message. It's initial
+         * cursor value for new reader.
+         * @return Sequence number.
+         */
+        uint64_t head() const;
+
+        /**
+         * @brief Method for reading message at cursor.
+         * If message was already overwritten, cursor is
+         * moved to oldest available message.
+         * @param cursor Reader cursor. Moved forward on success.
+         * @param message Result message.
+         * @param dropped Increased by number of skipped messages.
+         * @return Was message read.
+         */
+        bool read(uint64_t& cursor, MessagePtr& message, uint64_t& dropped) const;
+
+        /**
+         * @brief Method for checking is there published
+         * message at cursor. Claimed, but not published
+         * yet, messages are not counted.
+         * @param cursor Reader cursor.
+         * @return Can message be read.
+         */
+        bool canRead(uint64_t cursor) const;
+
+    private:
+        /**
+         * @brief Method for finding message at cursor.
+         * @param cursor Reader cursor. Moved forward on success.
+         * @param message Result message or nullptr, if
+         * message is not required.
+         * @param dropped Increased by number of skipped messages.
+         * @return Was message found.
+         */
+        bool find(uint64_t& cursor, MessagePtr* message, uint64_t& dropped) const;
+
+        struct Slot
+        {
+            mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+            // Sequence number of message plus one.
+            // 0 means, that slot is empty.
+            uint64_t sequence = 0;
+
+            // Object is reused, while readers don't hold it
+            std::shared_ptr<AbstractLogger::Message> message;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        uint64_t m_capacity;
+        std::atomic<uint64_t> m_head;
+    };
+}
+
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "Loggers/AbstractLogger.hpp"
+
+namespace Logger
+{
+    /**
+     * @brief Lock free bounded queue of packed
+     * messages with many producers and many consumers.
+     * Queue is ring of cache line sized blocks. Message
+     * takes several consecutive blocks: fixed header
+     * (timestamp, level, call site, thread, sizes) and
+     * inline text of context, message, fields and stack
+     * trace addresses. So
+     * pushing does not allocate memory and consumer
+     * reads message sequentially.
+     *
+     * Positions are counted in blocks. Every block has
+     * it's own sequence number, so messages, that are
+     * pushed and not popped yet, can be visited without
+     * locks (for example from signal handler).
+     */
+    class RecordQueue
+    {
+    public:
+        RecordQueue(const RecordQueue&) = delete;
+        RecordQueue& operator=(const RecordQueue&) = delete;
+
+        // Size of one block with it's sequence
+        static constexpr std::size_t BlockSize = 64;
+
+        // Size of block data
+        static constexpr std::size_t BlockDataSize = BlockSize - sizeof(uint64_t) - sizeof(uint32_t);
+
+        /**
+         * @brief Fixed part of packed message,
+         * that's stored at start of first block.
+         */
+        struct Header
+        {
+            uint64_t timestamp;
+            const char* filename;
+            std::thread::id thread;
+            int32_t line;
+            uint32_t contextSize;
+            uint32_t messageSize;
+            uint32_t fieldsSize;
+            AbstractLogger::ErrorClass errorClass;
+            bool history;
+            bool span;
+            uint16_t framesCount;
+        };
+
+        static_assert(sizeof(Header) < BlockDataSize, "Header does not fit into block");
+
+        /**
+         * @brief Class, that gives access to text of
+         * packed message without copying. It's used
+         * by `visit`.
+         */
+        class View
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param queue Queue.
+             * @param position Position of first block.
+             * @param header Message header.
+             */
+            View(const RecordQueue& queue, uint64_t position, const Header& header);
+
+            /**
+             * @brief Method for getting message header.
+             * @return Header.
+             */
+            const Header& header() const;
+
+            /**
+             * @brief Method for passing context text
+             * to callable by contiguous parts.
+             * @param function Callable, that receives
+             * `const char*` and `std::size_t`.
+             */
+            template<typename Function>
+            void context(Function&& function) const
+            {
+                m_queue.readParts(m_position, sizeof(Header), m_header.contextSize, function);
+            }
+
+            /**
+             * @brief Method for passing message text
+             * to callable by contiguous parts.
+             * @param function Callable, that receives
+             * `const char*` and `std::size_t`.
+             */
+            template<typename Function>
+            void message(Function&& function) const
+            {
+                m_queue.readParts(
+                    m_position,
+                    sizeof(Header) + m_header.contextSize,
+                    m_header.messageSize,
+                    function
+                );
+            }
+
+        private:
+            const RecordQueue& m_queue;
+            uint64_t m_position;
+            Header m_header;
+        };
+
+        /**
+         * @brief Constructor.
+         * @param blocks Number of blocks. Will be
+         * rounded up to power of two.
+         */
+        explicit RecordQueue(std::size_t blocks);
+
+        /**
+         * @brief Method for getting number of
+         * blocks, that's taken by message.
+         * @param message Message object.
+         * @return Number of blocks.
+         */
+        static std::size_t blocksCount(const AbstractLogger::Message& message);
+
+        /**
+         * @brief Method for pushing message. Text, that
+         * does not fit into whole queue, is truncated.
+         * @param message Message object.
+         * @return Is message pushed. False if there
+         * is no space for message.
+         */
+        bool tryPush(const AbstractLogger::Message& message);
+
+        /**
+         * @brief Method for popping message. Strings
+         * of result message are reused.
+         * @param message Result message.
+         * @param position Result position of message.
+         * @param blocks Result number of message blocks.
+         * Next message position is `position + blocks`.
+         * @return Is message popped. False if queue is empty.
+         */
+        bool tryPop(AbstractLogger::Message& message, uint64_t& position, uint64_t& blocks);
+
+        /**
+         * @brief Method for getting approximate
+         * number of taken blocks.
+         * @return Number of blocks.
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Method for getting position of
+         * next pushed message. It's number of blocks,
+         * that are pushed or being pushed.
+         * @return Position.
+         */
+        uint64_t pushPosition() const;
+
+        /**
+         * @brief Method for checking is queue empty.
+         * @return Is queue empty.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Method for visiting messages, that are
+         * pushed and not popped yet. It does not lock
+         * anything and does not allocate memory, so it
+         * can be used from signal handler. Messages can
+         * be popped while visiting, so it's best effort.
+         * @param visitor Callable, that receives `const View&`.
+         */
+        template<typename Visitor>
+        void visit(Visitor&& visitor) const
+        {
+            auto enqueue = m_enqueuePosition.load();
+
+            for (auto position = m_dequeuePosition.load(); position < enqueue;)
+            {
+                auto& block = m_blocks[position & (m_capacity - 1)];
+
+                // Only first block of message has published sequence
+                if (block.sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    ++position;
+                    continue;
+                }
+
+                Header header{};
+                readBytes(position, 0, &header, sizeof(Header));
+
+                visitor(View(*this, position, header));
+
+                position += block.blocks.load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct alignas(BlockSize) Block
+        {
+            std::atomic<uint64_t> sequence;
+
+            // Number of message blocks, it's
+            // set only in first block
+            std::atomic<uint32_t> blocks;
+
+            char data[BlockDataSize];
+        };
+
+        static_assert(sizeof(Block) == BlockSize, "Block has to take one cache line");
+
+        /**
+         * @brief Method for writing bytes of message,
+         * that starts at position.
+         * @param position Position of first block.
+         * @param offset Offset inside message.
+         * @param data Data.
+         * @param size Size of data.
+         */
+        void writeBytes(uint64_t position, std::size_t offset, const void* data, std::size_t size);
+
+        /**
+         * @brief Method for reading bytes of message,
+         * that starts at position.
+         * @param position Position of first block.
+         * @param offset Offset inside message.
+         * @param data Result data.
+         * @param size Size of data.
+         */
+        void readBytes(uint64_t position, std::size_t offset, void* data, std::size_t size) const;
+
+        /**
+         * @brief Method for passing message bytes
+         * to callable by contiguous parts.
+         * @param position Position of first block.
+         * @param offset Offset inside message.
+         * @param size Number of bytes.
+         * @param function Callable.
+         */
+        template<typename Function>
+        void readParts(uint64_t position, std::size_t offset, std::size_t size, Function& function) const
+        {
+            while (size != 0)
+            {
+                auto& block = m_blocks[(position + offset / BlockDataSize) & (m_capacity - 1)];
+                auto blockOffset = offset % BlockDataSize;
+                auto part = std::min(size, BlockDataSize - blockOffset);
+
+                function(block.data + blockOffset, part);
+
+                offset += part;
+                size -= part;
+            }
+        }
+
+        std::unique_ptr<Block[]> m_blocks;
+        uint64_t m_capacity;
+
+        alignas(64) std::atomic<uint64_t> m_enqueuePosition;
+        alignas(64) std::atomic<uint64_t> m_dequeuePosition;
+    };
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include "Epoch.hpp"
+#include "Loggers/AbstractLogger.hpp"
+#include "Formatters/AbstractFormatter.hpp"
+
+namespace Sinks
+{
+    class AbstractSink;
+
+    using SinkPtr = std::shared_ptr<AbstractSink>;
+
+    /**
+     * @brief Class, that describes abstract
+     * output of logger. Logger fans every message
+     * out to all of it's sinks. Each sink has it's
+     * own minimum error class and formatter.
+     */
+    class AbstractSink : public std::enable_shared_from_this<AbstractSink>
+    {
+    public:
+        AbstractSink(const AbstractSink&) = delete;
+        AbstractSink& operator=(const AbstractSink&) = delete;
+
+        /**
+         * @brief Constructor.
+         */
+        AbstractSink();
+
+        /**
+         * @brief Virtual destructor.
+         */
+        virtual ~AbstractSink() = default;
+
+        /**
+         * @brief Method for setting minimum
+         * message error class for this sink.
+         * @param errorClass Error class enum value.
+         */
+        virtual void setMinimumErrorClass(AbstractLogger::ErrorClass errorClass);
+
+        /**
+         * @brief Method for getting minimum
+         * message error class for this sink.
+         * @return Error class enum value.
+         */
+        virtual AbstractLogger::ErrorClass minimumErrorClass() const;
+
+        /**
+         * @brief Method for setting sink formatter.
+         * If formatter is nullptr (default) logger
+         * formatter will be used.
+         * @param formatter Formatter.
+         */
+        virtual void setFormatter(Formatters::FormatterPtr formatter);
+
+        /**
+         * @brief Method for getting sink formatter.
+         * @return Formatter or nullptr if logger formatter
+         * is used.
+         */
+        virtual Formatters::FormatterPtr formatter() const;
+
+        /**
+         * @brief Method for setting sink format string.
+         * Creates pattern formatter.
+         * @param format Format string.
+         */
+        void setFormat(std::string format);
+
+        /**
+         * @brief Method for enabling collapsing of
+         * repeated messages. If same call site sends
+         * same text several times in a row, only first
+         * message is written, followed by "last message
+         * repeated N times" when run ends or repeats
+         * window elapses, even if there are no new
+         * messages. Spans and messages with fields
+         * are never collapsed.
+         * @param enabled Is collapsing enabled.
+         */
+        void setRepeatsCollapsingEnabled(bool enabled);
+
+        /**
+         * @brief Method for checking is collapsing
+         * of repeated messages enabled.
+         * @return Is collapsing enabled.
+         */
+        bool repeatsCollapsingEnabled() const;
+
+        /**
+         * @brief Method for setting maximum time,
+         * for which repeats are collapsed into one
+         * line. Default value is 5 seconds.
+         * @param window Time window.
+         */
+        void setRepeatsWindow(std::chrono::milliseconds window);
+
+        /**
+         * @brief Method for getting maximum time,
+         * for which repeats are collapsed.
+         * @return Time window.
+         */
+        std::chrono::milliseconds repeatsWindow() const;
+
+        /**
+         * @brief Method for checking is message with
+         * specified error class has to be written to this sink.
+         * @param errorClass Error class.
+         * @return Is message accepted.
+         */
+        bool accepts(AbstractLogger::ErrorClass errorClass) const;
+
+        /**
+         * @brief Method for checking is sink accepts
+         * spans of `Logger::TraceSpan`. Spans are not
+         * checked with minimum error class. By default
+         * spans are not accepted.
+         * @return Are spans accepted.
+         */
+        virtual bool acceptsSpans() const;
+
+        /**
+         * @brief Method for writing formatted message.
+         * Logger will use this method. It's thread safe.
+         * @param message Message object.
+         * @param formatted Formatted message string.
+         * @param formatter Formatter, that was used. It's
+         * used to format repeats line. If it's nullptr
+         * repeats line is not formatted.
+         */
+        void write(const AbstractLogger::Message& message,
+                   const std::string& formatted,
+                   const Formatters::FormatterPtr& formatter = nullptr);
+
+        /**
+         * @brief Method for writing line about
+         * collapsed repeats, if there is any.
+         */
+        void flushRepeats();
+
+        /**
+         * @brief Method for finishing batch of messages.
+         * Logger calls it after every written batch,
+         * so sink can flush it's buffers. It's also
+         * called by timer, requested with `commitAt`.
+         */
+        void commit();
+
+        /**
+         * @brief Method for waiting all passed
+         * messages to be written.
+         */
+        virtual void waitForWritten();
+
+        /**
+         * @brief Method for waiting all passed
+         * messages to be written and stored
+         * durably. For example synced to disk.
+         * @return Are messages stored durably.
+         */
+        bool sync();
+
+    protected:
+
+        /**
+         * @brief Method that's called on new message.
+         * Calls are serialized by sink.
+         * @param message Message object.
+         * @param formatted Formatted message string.
+         */
+        virtual void onWrite(const AbstractLogger::Message& message, const std::string& formatted) = 0;
+
+        /**
+         * @brief Method that's called at the end of
+         * messages batch. Calls are serialized by sink.
+         */
+        virtual void onCommit();
+
+        /**
+         * @brief Method that's called when all written
+         * messages has to be stored durably. Calls are
+         * serialized by sink.
+         * @return Are messages stored durably.
+         */
+        virtual bool onSync();
+
+        /**
+         * @brief Method for requesting `commit` call at
+         * specified time, even if logger has no new
+         * messages. It's done by common timer thread and
+         * only for sinks, that are owned by shared pointer.
+         * Has to be called from `onWrite` or `onCommit`.
+         * @param time Time of commit.
+         */
+        void commitAt(std::chrono::steady_clock::time_point time);
+
+        /**
+         * @brief Method for getting formatter, that was
+         * used for message, passed to `onWrite`. It can
+         * be called only from `onWrite`.
+         * @return Formatter or nullptr.
+         */
+        const Formatters::FormatterPtr& writeFormatter() const;
+
+    private:
+        /**
+         * @brief Method for checking is message
+         * repeats last written one.
+         * @param message Message object.
+         * @return Is message repeated.
+         */
+        bool isRepeat(const AbstractLogger::Message& message) const;
+
+        /**
+         * @brief Method for writing line about
+         * collapsed repeats. Sink has to be locked.
+         */
+        void writeRepeats();
+
+        std::atomic<AbstractLogger::ErrorClass> m_minErrorClass;
+        Epoch::Atomic<Formatters::FormatterPtr> m_formatter;
+
+        std::mutex m_writeMutex;
+
+        // Formatter of message, that's passed to `onWrite`
+        const Formatters::FormatterPtr* m_writeFormatter;
+
+        std::atomic_bool m_collapseRepeats;
+        std::atomic<std::chrono::milliseconds> m_repeatsWindow;
+
+        // Only last written message is kept
+        AbstractLogger::Message m_lastMessage;
+        Formatters::FormatterPtr m_lastFormatter;
+        bool m_hasLastMessage;
+        uint64_t m_repeats;
+        std::chrono::system_clock::time_point m_repeatsStart;
+        std::chrono::system_clock::time_point m_lastRepeat;
+
+        // Time of requested timed commit or zero
+        std::chrono::steady_clock::time_point m_commitTime;
+    };
+}
+
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include "FileSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief File sink, that can be used by several
+     * processes with same log directory. Every line
+     * is written with one `write` call to file opened
+     * with `O_APPEND`, so lines of different processes
+     * do not tear. Rotation is serialized with lock file
+     * and file, rotated by other process, is reopened
+     * at the end of batch. Available only on Linux.
+     */
+    class AppendFileSink : public FileSink
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        AppendFileSink();
+
+        /**
+         * @brief Destructor. Closes current log file.
+         */
+        ~AppendFileSink() override;
+
+        /**
+         * @brief Method for setting maximum line
+         * size with line ending. Longer lines are
+         * truncated, so every line is written at once.
+         * Default value is 64 KiB.
+         * @param bytes Number of bytes.
+         */
+        void setMaximumLineSize(std::size_t bytes);
+
+        /**
+         * @brief Method for getting maximum line size.
+         * @return Number of bytes.
+         */
+        std::size_t maximumLineSize() const;
+
+    protected:
+        void onCommit() override;
+
+        /**
+         * @brief Rotation is done under lock file,
+         * so only one process renames log file.
+         */
+        std::string getLogPath() const override;
+
+        int64_t openFile(const std::string& path) override;
+
+        void closeFile() override;
+
+        bool isFileOpened() const override;
+
+        void writeLine(const std::string& formatted) override;
+
+        void flushFile() override;
+
+        bool syncFile() override;
+
+    private:
+        int m_fd;
+        std::string m_path;
+        std::string m_line;
+        std::atomic<std::size_t> m_maximumLineSize;
+    };
+}
+
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <queue>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that passes messages to other
+     * sink through dedicated queue and thread. So
+     * slow sink will not stall other sinks of logger.
+     * Minimum error class and formatter of wrapped
+     * sink are used. Queue is bounded, if it's full
+     * messages wait for free space or are dropped.
+     */
+    class AsyncSink : public AbstractSink
+    {
+    public:
+
+        enum class Overflow
+        {
+            Block   //< Logger waits for free space in queue. Default value.
+            , Drop  //< Message is dropped and counted.
+        };
+
+        /**
+         * @brief Constructor.
+         * @param sink Wrapped sink.
+         * @param capacity Maximum number of queued messages.
+         * @param overflow Behavior on full queue.
+         */
+        explicit AsyncSink(SinkPtr sink,
+                           std::size_t capacity = 16384,
+                           Overflow overflow = Overflow::Block);
+
+        /**
+         * @brief Destructor. Waits until all
+         * messages will be written.
+         */
+        ~AsyncSink() override;
+
+        /**
+         * @brief Method for getting wrapped sink.
+         * @return Sink.
+         */
+        SinkPtr sink() const;
+
+        /**
+         * @brief Method for getting number of messages,
+         * that are dropped because of full queue.
+         * @return Number of messages.
+         */
+        uint64_t droppedMessages() const;
+
+        void setMinimumErrorClass(AbstractLogger::ErrorClass errorClass) override;
+
+        AbstractLogger::ErrorClass minimumErrorClass() const override;
+
+        bool acceptsSpans() const override;
+
+        void setFormatter(Formatters::FormatterPtr formatter) override;
+
+        Formatters::FormatterPtr formatter() const override;
+
+        /**
+         * @brief Method for waiting dedicated thread
+         * to write all messages.
+         */
+        void waitForWritten() override;
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+        bool onSync() override;
+
+    private:
+        struct Entry
+        {
+            AbstractLogger::Message message;
+            std::string formatted;
+
+            // Wrapped sink formats it's repeats line with it
+            Formatters::FormatterPtr formatter;
+        };
+
+        void writingThread();
+
+        SinkPtr m_sink;
+
+        bool m_working;
+        bool m_writing;
+        std::queue<Entry> m_entries;
+        std::size_t m_capacity;
+        Overflow m_overflow;
+        std::atomic<uint64_t> m_dropped;
+        std::mutex m_entriesMutex;
+        std::condition_variable m_cond;
+        std::condition_variable m_clearVariable;
+        std::condition_variable m_spaceVariable;
+
+        std::thread m_thread;
+    };
+}
+
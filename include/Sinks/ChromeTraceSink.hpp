@@ -0,0 +1,57 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that writes spans of `Logger::TraceSpan`
+     * and important messages into file in Chrome Trace
+     * Event JSON array format, that can be opened in
+     * Perfetto or chrome://tracing. Array is closed on
+     * destruction, but viewers open unfinished file too.
+     * Named threads get `thread_name` metadata event.
+     *
+     * Spans are accepted regardless of minimum error
+     * class. Other messages are written as instant events,
+     * if they are not lower than minimum error class.
+     * It's `Warning` by default.
+     */
+    class ChromeTraceSink : public AbstractSink
+    {
+    public:
+        /**
+         * @brief Constructor. Throws std::runtime_error
+         * if file can't be opened.
+         * @param path Path to trace file. File is truncated.
+         */
+        explicit ChromeTraceSink(const std::string& path);
+
+        /**
+         * @brief Destructor. Closes events array.
+         */
+        ~ChromeTraceSink() override;
+
+        /**
+         * @brief Sink accepts spans.
+         * @return True.
+         */
+        bool acceptsSpans() const override;
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+        void onCommit() override;
+
+    private:
+        void appendEvent(const std::string& event);
+
+        std::ofstream m_file;
+        std::string m_buffer;
+        bool m_empty;
+        std::unordered_set<uint32_t> m_namedThreads;
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that sends formatted messages to
+     * local `Logger::Collector` process. Messages are
+     * batched and sent as one datagram at the end of
+     * batch. If collector is not available, messages
+     * are passed to fallback sink, like
+     * `Sinks::AppendFileSink`, and connection is
+     * retried every second. Available only on Linux.
+     */
+    class CollectorSink : public AbstractSink
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param socketPath Path to collector socket.
+         * @param fallback Sink, that's used while collector
+         * is not available. If it's nullptr, messages are dropped.
+         */
+        explicit CollectorSink(std::string socketPath, SinkPtr fallback = nullptr);
+
+        /**
+         * @brief Destructor. Sends rest of messages.
+         */
+        ~CollectorSink() override;
+
+        /**
+         * @brief Method for getting collector socket path.
+         * @return Path to socket.
+         */
+        const std::string& socketPath() const;
+
+        /**
+         * @brief Method for checking is sink
+         * connected to collector.
+         * @return Is connected.
+         */
+        bool isConnected() const;
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+        void onCommit() override;
+
+        bool onSync() override;
+
+    private:
+        /**
+         * @brief Method for connecting to collector,
+         * if retry interval elapsed.
+         * @return Is connected.
+         */
+        bool connect();
+
+        /**
+         * @brief Method for sending batched records.
+         * If collector is gone, records are written
+         * to fallback sink.
+         */
+        void send();
+
+        /**
+         * @brief Method for writing batched
+         * records to fallback sink.
+         */
+        void writeFallback();
+
+        std::string m_socketPath;
+        SinkPtr m_fallback;
+        std::atomic<int> m_fd;
+        std::string m_datagram;
+        std::chrono::steady_clock::time_point m_nextConnect;
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that writes messages
+     * to rolling log files. Rotation is done by
+     * this class, while writing to opened file
+     * can be changed by derived classes.
+     */
+    class FileSink : public AbstractSink
+    {
+    public:
+
+        enum class Durability
+        {
+            None          //< Log file is never synced. Default value.
+            , Periodic    //< Log file is synced, when sync interval elapsed since last sync. Sync is done at the end of batch or by timer, if there are no new batches.
+            , GroupCommit //< Log file is synced at the end of batch, if batch contains `Error` message.
+        };
+
+        /**
+         * @brief Constructor.
+         */
+        FileSink();
+
+        /**
+         * @brief Destructor. Closes log file.
+         */
+        ~FileSink() override;
+
+        /**
+         * @brief Method for setting log file durability.
+         * Log file is always synced on `sync` call.
+         * @param durability Durability enum value.
+         */
+        void setDurability(Durability durability);
+
+        /**
+         * @brief Method for getting log file durability.
+         * @return Durability enum value.
+         */
+        Durability durability() const;
+
+        /**
+         * @brief Method for setting interval between
+         * log file syncs for `Durability::Periodic`.
+         * Default value is 1 second.
+         * @param interval Interval.
+         */
+        void setSyncInterval(std::chrono::milliseconds interval);
+
+        /**
+         * @brief Method for getting interval between
+         * log file syncs for `Durability::Periodic`.
+         * @return Interval.
+         */
+        std::chrono::milliseconds syncInterval() const;
+
+        /**
+         * @brief Method for setting path to directory
+         * where all file logs will contains. File logs
+         * are rolling logs. If there will no such directory
+         * there will no any file logs. Default value is "logs".
+         * @param path Path to directory.
+         */
+        void setLogPath(std::string path);
+
+        /**
+         * @brief Method for getting path to directory
+         * where all file logs will contains. Default value is "logs".
+         * @return Path to directory.
+         */
+        std::string logPath() const;
+
+        /**
+         * @brief Method for setting maximum log
+         * file size in bytes. If log file
+         * will be bigger than maximum value
+         * log rotation will be applied. If
+         * value will be 0 - there will no
+         * rotation.
+         * @param bytes Number of bytes.
+         */
+        void setMaximumLogFile(uint64_t bytes);
+
+        /**
+         * @brief Method for getting maximum log
+         * file size.
+         * @return Number of bytes.
+         */
+        uint64_t maximumLogFile() const;
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+        void onCommit() override;
+
+        bool onSync() override;
+
+        /**
+         * @brief Method for getting log file path, using
+         * log file rotation.
+         * @return Path to current log file.
+         */
+        virtual std::string getLogPath() const;
+
+        /**
+         * @brief Method for opening log file for appending.
+         * @param path Path to log file.
+         * @return Size of opened file in bytes or -1
+         * if file can't be opened.
+         */
+        virtual int64_t openFile(const std::string& path);
+
+        /**
+         * @brief Method for closing opened log file.
+         */
+        virtual void closeFile();
+
+        /**
+         * @brief Method for checking is log file opened.
+         * @return Is file opened.
+         */
+        virtual bool isFileOpened() const;
+
+        /**
+         * @brief Method for appending line to opened log file.
+         * @param formatted Formatted message without line ending.
+         */
+        virtual void writeLine(const std::string& formatted);
+
+        /**
+         * @brief Method for flushing written data.
+         */
+        virtual void flushFile();
+
+        /**
+         * @brief Method for syncing flushed data of
+         * opened log file to disk.
+         * @return Is data synced.
+         */
+        virtual bool syncFile();
+
+    private:
+        /**
+         * @brief Method for syncing opened log file,
+         * if it has unsynced data. Failure is kept
+         * until next `onSync` call.
+         */
+        void syncIfRequired();
+
+        std::ofstream m_outputFile;
+        uint64_t m_outputFileSize;
+
+        // Descriptor of file, that's opened by stream
+        int m_syncDescriptor;
+
+        std::atomic<Durability> m_durability;
+        std::atomic<std::chrono::milliseconds> m_syncInterval;
+        std::chrono::steady_clock::time_point m_lastSync;
+        bool m_hasUnsyncedData;
+        bool m_hasDurableMessages;
+        bool m_syncFailed;
+
+        std::atomic<uint64_t> m_maxLogFileSizeBytes;
+        Epoch::Atomic<std::string> m_fileLogPath;
+    };
+}
+
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include "FileSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief File sink, that writes messages directly
+     * into memory mapped log file. File is preallocated
+     * with big chunks and truncated to real length on
+     * rotation or close. Available only on Linux.
+     */
+    class MappedFileSink : public FileSink
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        MappedFileSink();
+
+        /**
+         * @brief Destructor. Truncates and closes
+         * current log file.
+         */
+        ~MappedFileSink() override;
+
+        /**
+         * @brief Method for setting size of chunk, that
+         * will be preallocated when mapped file is full.
+         * Default value is 1 MiB.
+         * @param bytes Number of bytes.
+         */
+        void setPreallocationSize(uint64_t bytes);
+
+        /**
+         * @brief Method for getting size of chunk, that
+         * will be preallocated when mapped file is full.
+         * @return Number of bytes.
+         */
+        uint64_t preallocationSize() const;
+
+    protected:
+        int64_t openFile(const std::string& path) override;
+
+        void closeFile() override;
+
+        bool isFileOpened() const override;
+
+        void writeLine(const std::string& formatted) override;
+
+        void flushFile() override;
+
+        bool syncFile() override;
+
+    private:
+        /**
+         * @brief Method for making sure, that mapped
+         * region can contain specified number of bytes.
+         * @param bytes Required number of bytes.
+         * @return Is region big enough.
+         */
+        bool reserve(uint64_t bytes);
+
+        int m_fd;
+        char* m_data;
+        uint64_t m_length;
+        uint64_t m_capacity;
+        uint64_t m_preallocationSize;
+    };
+}
+
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that writes formatted messages
+     * into POSIX shared memory ring. Writing is
+     * only memory copy without system calls. Ring is
+     * not removed on destruction, so messages can be
+     * read by `Sinks::SharedMemoryReader` (or
+     * `alogger-shmdump` tool) while process is alive
+     * or after it was killed. Available only on Linux.
+     */
+    class SharedMemorySink : public AbstractSink
+    {
+    public:
+        // Ring header magic value
+        static constexpr uint64_t Magic = 0x314D4853474F4C41ULL; // "ALOGSHM1"
+
+        // Record, that fills end of ring before wrap
+        static constexpr uint8_t PaddingRecord = 0xFF;
+
+        /**
+         * @brief Struct, that's placed at the
+         * beginning of shared memory.
+         */
+        struct Header
+        {
+            uint64_t magic;
+            uint64_t capacity;
+            int64_t pid;
+
+            // Position of oldest record, that's not overwritten
+            std::atomic<uint64_t> tailPosition;
+
+            // Position after last committed record
+            std::atomic<uint64_t> headPosition;
+        };
+
+        /**
+         * @brief Struct, that's placed before
+         * every record text. Records are aligned
+         * to 8 bytes.
+         */
+        struct RecordHeader
+        {
+            // Sequence number of record. It's
+            // 0 while record is being written.
+            std::atomic<uint64_t> commit;
+            int64_t time;
+            uint32_t size;
+            uint8_t errorClass;
+        };
+
+        /**
+         * @brief Constructor. Creates shared memory
+         * object or reuses existing one. Throws
+         * std::runtime_error on failure.
+         * @param name Shared memory object name, like "/myapp".
+         * @param capacity Size of records area in bytes.
+         */
+        explicit SharedMemorySink(std::string name, std::size_t capacity = 4 * 1024 * 1024);
+
+        /**
+         * @brief Destructor. Unmaps shared memory,
+         * object is not removed.
+         */
+        ~SharedMemorySink() override;
+
+        /**
+         * @brief Method for getting shared memory
+         * object name.
+         * @return Name.
+         */
+        const std::string& name() const;
+
+        /**
+         * @brief Method for removing shared memory
+         * object.
+         * @param name Shared memory object name.
+         */
+        static void remove(const std::string& name);
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+    private:
+        /**
+         * @brief Method for getting record header
+         * at position.
+         * @param position Ring position.
+         * @return Record header.
+         */
+        RecordHeader* recordAt(uint64_t position) const;
+
+        /**
+         * @brief Method for moving tail, so range
+         * before specified position can be overwritten.
+         * @param end End of range, that will be written.
+         */
+        void releaseSpace(uint64_t end);
+
+        std::string m_name;
+        std::size_t m_mappedSize;
+        Header* m_header;
+        char* m_data;
+        uint64_t m_capacity;
+        uint64_t m_sequence;
+    };
+
+    /**
+     * @brief Class for reading records of
+     * `Sinks::SharedMemorySink` from other process.
+     * Writer is not blocked by reader.
+     */
+    class SharedMemoryReader
+    {
+    public:
+        SharedMemoryReader(const SharedMemoryReader&) = delete;
+        SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+
+        /**
+         * @brief Struct, that describes one record.
+         */
+        struct Record
+        {
+            uint64_t sequence;
+            std::chrono::system_clock::time_point timePoint;
+            AbstractLogger::ErrorClass errorClass;
+            std::string text;
+        };
+
+        /**
+         * @brief Constructor. Opens shared memory
+         * object for reading. Throws std::runtime_error
+         * if there is no such object or it's not a ring.
+         * @param name Shared memory object name.
+         */
+        explicit SharedMemoryReader(const std::string& name);
+
+        /**
+         * @brief Destructor.
+         */
+        ~SharedMemoryReader();
+
+        /**
+         * @brief Method for reading records, that
+         * were written after previous call. On first call
+         * all available records are read.
+         * @param records Result records.
+         * @return Number of read records.
+         */
+        std::size_t read(std::vector<Record>& records);
+
+        /**
+         * @brief Method for getting number of records,
+         * that were overwritten before they were read.
+         * @return Number of records.
+         */
+        uint64_t droppedRecords() const;
+
+        /**
+         * @brief Method for checking is writing
+         * process still alive.
+         * @return Is writer alive.
+         */
+        bool isWriterAlive() const;
+
+    private:
+        std::size_t m_mappedSize;
+        const SharedMemorySink::Header* m_header;
+        const char* m_data;
+        uint64_t m_capacity;
+        uint64_t m_position;
+        uint64_t m_lastSequence;
+        uint64_t m_dropped;
+    };
+}
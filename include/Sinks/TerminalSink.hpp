@@ -0,0 +1,26 @@
+#pragma once
+
+#include "AbstractSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief Sink, that writes messages to terminal.
+     * Messages with error class higher than `Info`
+     * are written to stderr.
+     */
+    class TerminalSink : public AbstractSink
+    {
+    public:
+        /**
+         * @brief Constructor.
+         */
+        TerminalSink();
+
+    protected:
+        void onWrite(const AbstractLogger::Message& message, const std::string& formatted) override;
+
+        void onCommit() override;
+    };
+}
+
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "FileSink.hpp"
+
+namespace Sinks
+{
+    /**
+     * @brief File sink, that submits writes
+     * asynchronously through io_uring with registered
+     * buffers. If io_uring is not available, writes
+     * are passed to dedicated `pwrite` thread. So
+     * writing thread does not wait for disk. Buffers
+     * are submitted on every batch end, so sink is
+     * intended to be used with `Loggers::AsyncLogger`.
+     * Available only on Linux.
+     */
+    class UringFileSink : public FileSink
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param bufferSize Size of every registered buffer.
+         * @param buffersCount Number of registered buffers.
+         */
+        explicit UringFileSink(std::size_t bufferSize = 256 * 1024,
+                               std::size_t buffersCount = 8);
+
+        /**
+         * @brief Destructor. Waits for all
+         * submitted writes.
+         */
+        ~UringFileSink() override;
+
+        /**
+         * @brief Method for checking is io_uring
+         * used, or writes are done by fallback thread.
+         * @return Is io_uring used.
+         */
+        bool isUringUsed() const;
+
+        /**
+         * @brief Method for setting maximum size of
+         * buffers, that can wait for disk. If disk
+         * is stalled, sink allocates additional buffers
+         * until this limit. After that writing
+         * thread will wait for disk. Default value is 64 MiB.
+         * @param bytes Number of bytes.
+         */
+        void setMaximumPendingBytes(uint64_t bytes);
+
+        /**
+         * @brief Method for getting maximum number
+         * of bytes, that can wait for disk.
+         * @return Number of bytes.
+         */
+        uint64_t maximumPendingBytes() const;
+
+        /**
+         * @brief Method for getting number of writes,
+         * that failed after retries. File is truncated at
+         * offset of failed write, when submitted writes
+         * are finished, so there are no holes in file, but
+         * lines of writes, submitted before truncation,
+         * are lost. Next sync reports failure.
+         * @return Number of failed writes.
+         */
+        uint64_t failedWrites() const;
+
+    protected:
+        int64_t openFile(const std::string& path) override;
+
+        void closeFile() override;
+
+        bool isFileOpened() const override;
+
+        void writeLine(const std::string& formatted) override;
+
+        void flushFile() override;
+
+        /**
+         * @brief Syncing waits for all submitted writes.
+         */
+        bool syncFile() override;
+
+    private:
+        class Backend;
+        class UringBackend;
+        class ThreadBackend;
+
+        struct Buffer
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t capacity;
+            std::size_t used;
+            std::size_t written;
+            uint64_t offset;
+            int retries;
+            bool registered;
+            bool inFlight;
+        };
+
+        /**
+         * @brief Method for taking free buffer,
+         * that can contain specified number of bytes.
+         * @param bytes Number of bytes.
+         * @return Buffer index.
+         */
+        std::size_t acquireBuffer(std::size_t bytes);
+
+        /**
+         * @brief Method for submitting current buffer.
+         */
+        void submitCurrent();
+
+        /**
+         * @brief Method for submitting rest of buffer.
+         * @param index Buffer index.
+         */
+        void submit(std::size_t index);
+
+        /**
+         * @brief Method for processing finished writes.
+         * @param wait Wait for at least one write.
+         */
+        void reap(bool wait);
+
+        /**
+         * @brief Method for truncating file at offset
+         * of failed write. All writes have to be finished.
+         */
+        void truncateFailed();
+
+        std::unique_ptr<Backend> m_backend;
+
+        std::vector<Buffer> m_buffers;
+        std::vector<std::size_t> m_freeBuffers;
+        std::vector<std::pair<std::size_t, int64_t>> m_completed;
+        std::size_t m_bufferSize;
+        std::size_t m_currentBuffer;
+        std::size_t m_inFlight;
+        uint64_t m_pendingBytes;
+        uint64_t m_maxPendingBytes;
+
+        int m_fd;
+        uint64_t m_offset;
+
+        // Offset of first failed write or maximum value
+        uint64_t m_failedOffset;
+        bool m_hasFailedWrites;
+        std::atomic<uint64_t> m_failedWrites;
+    };
+}
+
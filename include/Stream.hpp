@@ -2,7 +2,10 @@
 
 
 #include <ostream>
+#include <string_view>
 #include "Loggers/AbstractLogger.hpp"
+#include "Categories.hpp"
+#include "Fields.hpp"
 
 namespace Loggers
 {
@@ -24,6 +27,7 @@ namespace Loggers
 
         /**
          * @brief Class for pushing next message setup.
+         * Message timestamp is taken here.
          * @param logger Logger object.
          * @param errorClass Next message error class.
          * @param filename Next message filename.
@@ -31,17 +35,26 @@ namespace Loggers
          * @param thread Thread id.
          * @param classname Next message classname.
          * @param function Next message funciton.
+         * @param action Next message action.
          */
-        void newMessage(LoggerPtr logger,
+        void newMessage(AbstractLogger* logger,
                         AbstractLogger::ErrorClass errorClass,
                         const char* filename,
                         int line,
                         std::thread::id thread,
                         std::string classname,
-                        const char* function);
+                        const char* function,
+                        Logger::CallSite::Action action);
 
         /**
-         * @brief Method for posting message to binded logger.
+         * @brief Method for adding field to next message.
+         * @param field Field.
+         */
+        void addField(Logger::Field field);
+
+        /**
+         * @brief Method for posting message to binded logger
+         * or to flight recorder.
          */
         void postMessage();
 
@@ -51,13 +64,114 @@ namespace Loggers
     private:
         std::string m_ss;
 
-        LoggerPtr m_logger;
+        AbstractLogger* m_logger;
         AbstractLogger::ErrorClass m_errorClass;
         const char* m_filename;
         int m_line;
         std::thread::id m_thread;
         std::string m_classname;
         const char* m_function;
+        Logger::CallSite::Action m_action;
+        Logger::Fields m_fields;
+        uint64_t m_timestamp;
+    };
+
+    /**
+     * @brief Helper for logging macros, that makes
+     * stream operands lazy. Macro is expanded into
+     * `!StreamGate::open(action) ? (void)0 : StreamGate() & Stream(...) << ...`,
+     * so operands of skipped message are not evaluated
+     * and macro is still single expression (it's safe
+     * inside `if`/`else` without braces). Call site action
+     * is taken once and passed to stream by `action()`.
+     */
+    class StreamGate
+    {
+    public:
+        /**
+         * @brief Method for storing action of
+         * next message in current thread.
+         * @param action Call site action.
+         * @return Is message not skipped.
+         */
+        static bool open(Logger::CallSite::Action action)
+        {
+            m_action = action;
+
+            return action != Logger::CallSite::Action::Skip;
+        }
+
+        /**
+         * @brief Method for getting action, that
+         * was stored by last `open` call in current thread.
+         * @return Call site action.
+         */
+        static Logger::CallSite::Action action()
+        {
+            return m_action;
+        }
+
+        /**
+         * @brief Method for storing class name of next
+         * message in current thread, so class name
+         * expression of macro is evaluated once. View
+         * is valid until end of macro full expression.
+         * @param classname Class name.
+         * @return Class name.
+         */
+        static std::string_view classname(std::string_view classname)
+        {
+            m_classname = classname;
+
+            return classname;
+        }
+
+        /**
+         * @brief Method for getting class name, that
+         * was stored by last `classname` call in
+         * current thread.
+         * @return Class name.
+         */
+        static std::string_view classname()
+        {
+            return m_classname;
+        }
+
+        /**
+         * @brief Method for getting action of class call
+         * site. If message is not skipped, cached name
+         * of static type is stored as class name, so
+         * name and category are taken from same type.
+         * @param site Call site.
+         * @param errorClass Message error class.
+         * @param type Static type of class, that's logging.
+         * @return Call site action.
+         */
+        static Logger::CallSite::Action classAction(Logger::CallSite& site,
+                                                    AbstractLogger::ErrorClass errorClass,
+                                                    const std::type_info& type)
+        {
+            auto action = site.action(errorClass, type);
+
+            if (action != Logger::CallSite::Action::Skip)
+            {
+                m_classname = site.typeName(type);
+            }
+
+            return action;
+        }
+
+        /**
+         * @brief Operator, that turns result of stream
+         * expression into `void`. It has lower priority,
+         * than `<<`, so it's applied after all operands.
+         */
+        void operator&(const std::ostream&) const
+        {}
+
+    private:
+        static thread_local Logger::CallSite::Action m_action;
+        static thread_local std::string_view m_classname;
     };
 
     /**
@@ -67,13 +181,40 @@ namespace Loggers
     {
     public:
         /**
-         * @brief Constructor.
+         * @brief Constructor. Logger is not owned by stream,
+         * it has to be alive until stream destruction.
+         * @param logger Pointer to logger implementation. If
+         * it's nullptr, message is dropped.
+         * @param errorClass Error class.
+         * @param filename Filename.
+         * @param line Line number.
+         * @param classname Class name.
+         * @param function Function name.
+         * @param action Action, taken by call site. Skipped
+         * message is not passed to logger, recorded message is
+         * passed only to flight recorder.
+         */
+        Stream(AbstractLogger* logger,
+               AbstractLogger::ErrorClass errorClass,
+               const char* filename,
+               int line,
+               std::thread::id thread,
+               std::string classname,
+               const char* function,
+               Logger::CallSite::Action action = Logger::CallSite::Action::Log);
+
+        /**
+         * @brief Constructor. Logger is kept
+         * alive until stream destruction.
          * @param logger Pointer to logger implementation.
          * @param errorClass Error class.
          * @param filename Filename.
          * @param line Line number.
          * @param classname Class name.
          * @param function Function name.
+         * @param action Action, taken by call site. Skipped
+         * message is not passed to logger, recorded message is
+         * passed only to flight recorder.
          */
         Stream(LoggerPtr logger,
                AbstractLogger::ErrorClass errorClass,
@@ -81,13 +222,16 @@ namespace Loggers
                int line,
                std::thread::id thread,
                std::string classname,
-               const char* function);
+               const char* function,
+               Logger::CallSite::Action action = Logger::CallSite::Action::Log);
 
         /**
          * @brief Destructor.
          */
         ~Stream() override;
 
+    private:
+        LoggerPtr m_owner;
     };
 }
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <thread>
+
+namespace Logger
+{
+    /**
+     * @brief Global registry of human-readable
+     * thread names, like "io-3". Formatters take
+     * rendered thread id and name from per thread
+     * cache, so rendering is done once per thread.
+     */
+    class Threads
+    {
+    public:
+        /**
+         * @brief Struct, that describes rendered
+         * thread id and name.
+         */
+        struct Rendered
+        {
+            // Hex id, like `0x00007f0a1b2c3d40`
+            std::string id;
+
+            // Registered name or rendered id, if
+            // thread has no name
+            std::string name;
+        };
+
+        /**
+         * @brief Method for setting name of current
+         * thread. Name is removed on thread exit.
+         * Thread safe.
+         * @param name Thread name. Empty name removes it.
+         */
+        static void setName(std::string name);
+
+        /**
+         * @brief Method for getting registered
+         * thread name.
+         * @param thread Thread id.
+         * @return Thread name or empty string.
+         */
+        static std::string name(std::thread::id thread);
+
+        /**
+         * @brief Method for getting rendered thread
+         * id and name. Result is cached by calling thread
+         * and valid until next call from this thread.
+         * @param thread Thread id.
+         * @return Rendered id and name.
+         */
+        static const Rendered& render(std::thread::id thread);
+    };
+}
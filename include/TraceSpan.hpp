@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Loggers/AbstractLogger.hpp"
+
+#define ALOGGER_CONCAT_IMPL(A, B) A##B
+#define ALOGGER_CONCAT(A, B) ALOGGER_CONCAT_IMPL(A, B)
+
+// Measures current scope. Usage: `LogScope("db.query");` or
+// `LogScope("db.query", std::chrono::milliseconds(10));`
+#define LogScope(...) Logger::TraceSpan ALOGGER_CONCAT(aloggerSpan, __LINE__)(__FILENAME__, __LINE__, __FUNCTION__, __VA_ARGS__)
+
+namespace Logger
+{
+    /**
+     * @brief RAII span, that measures time of scope.
+     * Only two raw clock values are taken, span is
+     * passed to current logger on destruction as message
+     * with span flag, span name as text, begin time as
+     * message time and duration. So it goes through async
+     * pipeline like other messages, but it's written only
+     * by sinks, that accept spans, like `Sinks::ChromeTraceSink`.
+     *
+     * Spans are recorded only if they are enabled. Span
+     * with threshold logs warning, if it takes longer,
+     * even if spans are disabled.
+     */
+    class TraceSpan
+    {
+    public:
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+        /**
+         * @brief Method for enabling recording of spans.
+         * Disabled by default.
+         * @param enabled Are spans enabled.
+         */
+        static void setEnabled(bool enabled);
+
+        /**
+         * @brief Method for checking are spans enabled.
+         * @return Are spans enabled.
+         */
+        static bool isEnabled()
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Constructor. Takes begin time.
+         * @param filename Filename.
+         * @param line Line in source code.
+         * @param function Function name.
+         * @param name Span name. It's not copied, so it
+         * has to outlive span, like string literal.
+         * @param threshold Duration, after which warning
+         * is logged. Zero disables warning.
+         */
+        TraceSpan(const char* filename,
+                  int line,
+                  const char* function,
+                  const char* name,
+                  std::chrono::milliseconds threshold = std::chrono::milliseconds(0));
+
+        /**
+         * @brief Destructor. Takes end time and
+         * passes span to current logger.
+         */
+        ~TraceSpan();
+
+    private:
+        const char* m_filename;
+        int m_line;
+        const char* m_function;
+        const char* m_name;
+        std::chrono::milliseconds m_threshold;
+
+        // Zero if span is not measured
+        uint64_t m_begin;
+
+        static std::atomic_bool m_enabled;
+    };
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <cxxabi.h>
+#include "Backtrace.hpp"
+#include "SystemTools.h"
+
+#if defined(OS_LINUX) && __has_include(<execinfo.h>)
+    #define ALOGGER_EXECINFO
+    #include <execinfo.h>
+    #include <dlfcn.h>
+#endif
+#ifdef OS_WINDOWS
+    #include <windows.h>
+#endif
+
+namespace
+{
+    // Addresses are never unloaded in most of
+    // applications, but cache is limited anyway
+    constexpr std::size_t MaximumCacheSize = 65536;
+
+    struct SymbolsCache
+    {
+        std::mutex mutex;
+        std::unordered_map<void*, std::string> symbols;
+    };
+
+    SymbolsCache& cache()
+    {
+        static SymbolsCache cache;
+
+        return cache;
+    }
+
+    std::string hex(uintptr_t value)
+    {
+        char buffer[2 + sizeof(uintptr_t) * 2 + 1];
+
+        std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(value));
+
+        return buffer;
+    }
+
+    std::string demangle(const char* name)
+    {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+
+        if (status != 0 || demangled == nullptr)
+        {
+            return name;
+        }
+
+        std::string result = demangled;
+
+        free(demangled);
+
+        return result;
+    }
+
+    std::string resolve(void* address)
+    {
+#ifdef ALOGGER_EXECINFO
+        Dl_info info{};
+
+        if (dladdr(address, &info) != 0)
+        {
+            auto module = SystemTools::Path::getFilename(info.dli_fname != nullptr ? info.dli_fname : "");
+
+            // Symbols of executable are visible only
+            // with `-rdynamic`, offset in module is
+            // enough for `addr2line`
+            if (info.dli_sname == nullptr)
+            {
+                return module + "+" + hex(
+                    reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase)
+                );
+            }
+
+            return demangle(info.dli_sname) + "+" + hex(
+                reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_saddr)
+            ) + " (" + module + ")";
+        }
+#endif
+
+        return hex(reinterpret_cast<uintptr_t>(address));
+    }
+}
+
+std::atomic<AbstractLogger::ErrorClass> Logger::Backtrace::m_level(AbstractLogger::ErrorClass::None);
+
+void Logger::Backtrace::setLevel(AbstractLogger::ErrorClass errorClass)
+{
+    m_level = errorClass;
+}
+
+AbstractLogger::ErrorClass Logger::Backtrace::level()
+{
+    return m_level;
+}
+
+void Logger::Backtrace::capture(std::vector<void*>& frames, std::size_t skip)
+{
+    // Frame of this method is skipped too
+    ++skip;
+
+    void* buffer[MaximumFrames + 8];
+    std::size_t size = 0;
+
+#ifdef ALOGGER_EXECINFO
+    size = static_cast<std::size_t>(::backtrace(buffer, static_cast<int>(std::min(MaximumFrames + skip, sizeof(buffer) / sizeof(void*)))));
+#endif
+#ifdef OS_WINDOWS
+    size = CaptureStackBackTrace(0, static_cast<DWORD>(std::min(MaximumFrames + skip, sizeof(buffer) / sizeof(void*))), buffer, nullptr);
+#endif
+
+    frames.clear();
+
+    if (size > skip)
+    {
+        frames.assign(buffer + skip, buffer + size);
+    }
+}
+
+std::string Logger::Backtrace::symbolize(void* address)
+{
+    auto& symbols = cache();
+
+    std::unique_lock<std::mutex> lock(symbols.mutex);
+
+    auto finded = symbols.symbols.find(address);
+
+    if (finded != symbols.symbols.end())
+    {
+        return finded->second;
+    }
+
+    auto symbol = resolve(address);
+
+    if (symbols.symbols.size() < MaximumCacheSize)
+    {
+        symbols.symbols.emplace(address, symbol);
+    }
+
+    return symbol;
+}
+
+std::size_t Logger::Backtrace::cacheSize()
+{
+    auto& symbols = cache();
+
+    std::unique_lock<std::mutex> lock(symbols.mutex);
+
+    return symbols.symbols.size();
+}
@@ -0,0 +1,171 @@
+#include <stdexcept>
+#include "BatchLogsListener.hpp"
+
+Logger::MessagesBatch::MessagesBatch() :
+    m_records(),
+    m_views(),
+    m_endCursor(0)
+{
+
+}
+
+std::size_t Logger::MessagesBatch::size() const
+{
+    return m_views.size();
+}
+
+bool Logger::MessagesBatch::empty() const
+{
+    return m_views.empty();
+}
+
+const Logger::MessageView& Logger::MessagesBatch::operator[](std::size_t index) const
+{
+    return m_views[index];
+}
+
+Logger::MessagesBatch::const_iterator Logger::MessagesBatch::begin() const
+{
+    return m_views.begin();
+}
+
+Logger::MessagesBatch::const_iterator Logger::MessagesBatch::end() const
+{
+    return m_views.end();
+}
+
+void Logger::MessagesBatch::clear()
+{
+    m_records.clear();
+    m_views.clear();
+}
+
+Logger::BatchLogsListener::BatchLogsListener() :
+    m_mutex(),
+    m_ring(nullptr),
+    m_cursor(0),
+    m_dropped(0)
+{
+
+}
+
+bool Logger::BatchLogsListener::borrowMessages(Logger::MessagesBatch& batch, std::size_t maximum)
+{
+    batch.clear();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_ring == nullptr)
+    {
+        return false;
+    }
+
+    auto cursor = m_cursor;
+    MessagesRing::MessagePtr record;
+
+    while (batch.m_records.size() < maximum &&
+           m_ring->read(cursor, record, m_dropped))
+    {
+        // Messages, skipped before first one, are not returned again
+        if (batch.m_records.empty())
+        {
+            m_cursor = cursor - 1;
+        }
+
+        batch.m_records.push_back(std::move(record));
+    }
+
+    if (batch.m_records.empty())
+    {
+        m_cursor = cursor;
+    }
+
+    batch.m_endCursor = cursor;
+
+    lock.unlock();
+
+    batch.m_views.reserve(batch.m_records.size());
+
+    for (auto&& message : batch.m_records)
+    {
+        batch.m_views.push_back({
+            message->time(),
+            message->errorClass,
+            message->message,
+            message->thread,
+            message->filename,
+            message->context,
+            message->line
+        });
+    }
+
+    return !batch.empty();
+}
+
+void Logger::BatchLogsListener::releaseMessages(Logger::MessagesBatch& batch)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (batch.m_endCursor > m_cursor)
+        {
+            m_cursor = batch.m_endCursor;
+        }
+    }
+
+    batch.clear();
+}
+
+uint64_t Logger::BatchLogsListener::droppedMessages() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    return m_dropped;
+}
+
+AbstractLogger::Message Logger::BatchLogsListener::popMessage()
+{
+    MessagesBatch batch;
+
+    if (!borrowMessages(batch, 1))
+    {
+        throw std::runtime_error("There is no messages in listener.");
+    }
+
+    auto message = *batch.m_records.front();
+
+    releaseMessages(batch);
+
+    return message;
+}
+
+bool Logger::BatchLogsListener::hasMessages() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Head counts claimed, but not published messages
+    return m_ring != nullptr && m_ring->canRead(m_cursor);
+}
+
+void Logger::BatchLogsListener::newMessage(const AbstractLogger::Message&)
+{
+
+}
+
+void Logger::BatchLogsListener::attach(std::shared_ptr<MessagesRing> ring)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_cursor = ring->head();
+    m_ring = std::move(ring);
+}
+
+void Logger::BatchLogsListener::detach(const std::shared_ptr<MessagesRing>& ring)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_ring == ring)
+    {
+        m_ring = nullptr;
+    }
+}
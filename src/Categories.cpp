@@ -0,0 +1,618 @@
+#include <map>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cxxabi.h>
+#include "Categories.hpp"
+#include "CurrentLogger.hpp"
+#include "FlightRecorder.hpp"
+#include "Epoch.hpp"
+
+namespace
+{
+    struct CategoriesConfiguration
+    {
+        std::map<std::string, AbstractLogger::ErrorClass> levels;
+        std::map<std::string, Logger::RateLimit> rateLimits;
+    };
+
+    // Call sites, that suppressed any message.
+    // Sites are static, so they are never removed.
+    std::atomic<Logger::CallSite*> g_limitedSites(nullptr);
+    std::atomic_bool g_hasSuppressed(false);
+    std::atomic<int64_t> g_nextSummary(0);
+
+    struct CategoryCacheEntry
+    {
+        const Logger::CallSite* site = nullptr;
+        uint64_t state = 0;
+        std::string category;
+    };
+
+    // Last categories of explicit category sites. It's direct
+    // mapped by site address, every thread has it's own.
+    thread_local std::array<CategoryCacheEntry, 64> t_categoryCache;
+}
+
+static int64_t steadyNanoseconds();
+
+namespace
+{
+    /**
+     * @brief Thread, that logs summary about suppressed
+     * messages into current logger, when summary interval
+     * is passed. So summary doesn't wait for next message.
+     * It's started by first suppressed message.
+     */
+    class SummaryTimer
+    {
+    public:
+        SummaryTimer() :
+            m_mutex(),
+            m_variable(),
+            m_working(true),
+            m_thread(&SummaryTimer::run, this)
+        {
+
+        }
+
+        ~SummaryTimer()
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_working = false;
+            }
+
+            m_variable.notify_all();
+            m_thread.join();
+        }
+
+        /**
+         * @brief Method for waking timer after
+         * summary time change.
+         */
+        void wake()
+        {
+            // Lock prevents wakeup between check and wait
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+            }
+
+            m_variable.notify_all();
+        }
+
+    private:
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (m_working)
+            {
+                auto next = g_nextSummary.load();
+
+                if (next == 0)
+                {
+                    m_variable.wait(lock);
+                    continue;
+                }
+
+                auto now = steadyNanoseconds();
+
+                if (now < next)
+                {
+                    m_variable.wait_for(lock, std::chrono::nanoseconds(next - now));
+                    continue;
+                }
+
+                lock.unlock();
+
+                std::string summary;
+
+                if (Logger::CallSite::takeSuppressedSummary(summary))
+                {
+                    log(std::move(summary));
+                }
+                else if (!g_hasSuppressed.load() &&
+                         g_nextSummary.compare_exchange_strong(next, 0) &&
+                         g_hasSuppressed.load())
+                {
+                    // Message was suppressed during stop,
+                    // so interval is started again
+                    next = 0;
+                    g_nextSummary.compare_exchange_strong(next, now);
+                }
+
+                lock.lock();
+            }
+        }
+
+        static void log(std::string summary)
+        {
+            CurrentLogger::Reference reference;
+
+            auto logger = reference.get();
+
+            if (logger == nullptr)
+            {
+                return;
+            }
+
+            logger->log(AbstractLogger::ErrorClass::Warning,
+                        "ALogger",
+                        0,
+                        std::this_thread::get_id(),
+                        std::string(),
+                        "RateLimit",
+                        std::move(summary));
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_variable;
+        bool m_working;
+        std::thread m_thread;
+    };
+
+    SummaryTimer& summaryTimer()
+    {
+        static SummaryTimer timer;
+
+        return timer;
+    }
+}
+
+std::atomic<uint64_t> Logger::Categories::m_generation(1);
+std::atomic<std::chrono::milliseconds> Logger::Categories::m_summaryInterval(std::chrono::seconds(10));
+
+static Epoch::Atomic<CategoriesConfiguration>& configuration()
+{
+    // Created on first use, logging can be done
+    // from static initialization
+    static Epoch::Atomic<CategoriesConfiguration> configuration;
+
+    return configuration;
+}
+
+static int64_t steadyNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+static std::string normalizeCategory(std::string category)
+{
+    if (category.size() >= 3 &&
+        category.compare(category.size() - 3, 3, "::*") == 0)
+    {
+        category.resize(category.size() - 3);
+    }
+
+    if (category == "*")
+    {
+        category.clear();
+    }
+
+    return category;
+}
+
+template<typename Map>
+static const typename Map::mapped_type* findClosest(const Map& map, const std::string& category)
+{
+    if (map.empty())
+    {
+        return nullptr;
+    }
+
+    std::string current = category;
+
+    // Looking for closest parent with override
+    while (true)
+    {
+        auto finded = map.find(current);
+
+        if (finded != map.end())
+        {
+            return &finded->second;
+        }
+
+        if (current.empty())
+        {
+            return nullptr;
+        }
+
+        auto position = current.rfind("::");
+
+        if (position == std::string::npos)
+        {
+            current.clear();
+        }
+        else
+        {
+            current.resize(position);
+        }
+    }
+}
+
+void Logger::Categories::setLevel(const std::string& category, AbstractLogger::ErrorClass errorClass)
+{
+    configuration().update(
+        [&category, errorClass](CategoriesConfiguration& configuration)
+        {
+            configuration.levels[normalizeCategory(category)] = errorClass;
+        }
+    );
+
+    ++m_generation;
+}
+
+void Logger::Categories::resetLevel(const std::string& category)
+{
+    configuration().update(
+        [&category](CategoriesConfiguration& configuration)
+        {
+            configuration.levels.erase(normalizeCategory(category));
+        }
+    );
+
+    ++m_generation;
+}
+
+void Logger::Categories::setDefaultLevel(AbstractLogger::ErrorClass errorClass)
+{
+    setLevel(std::string(), errorClass);
+}
+
+void Logger::Categories::invalidate()
+{
+    ++m_generation;
+}
+
+AbstractLogger::ErrorClass Logger::Categories::level(const std::string& category)
+{
+    Epoch::ReadGuard guard;
+
+    auto level = findClosest(configuration().load()->levels, category);
+
+    if (level == nullptr)
+    {
+        return AbstractLogger::ErrorClass::Unknown;
+    }
+
+    return *level;
+}
+
+void Logger::Categories::setRateLimit(const std::string& category, Logger::RateLimit limit)
+{
+    configuration().update(
+        [&category, &limit](CategoriesConfiguration& configuration)
+        {
+            configuration.rateLimits[normalizeCategory(category)] = limit;
+        }
+    );
+
+    ++m_generation;
+}
+
+void Logger::Categories::resetRateLimit(const std::string& category)
+{
+    configuration().update(
+        [&category](CategoriesConfiguration& configuration)
+        {
+            configuration.rateLimits.erase(normalizeCategory(category));
+        }
+    );
+
+    ++m_generation;
+}
+
+void Logger::Categories::setDefaultRateLimit(Logger::RateLimit limit)
+{
+    setRateLimit(std::string(), limit);
+}
+
+Logger::RateLimit Logger::Categories::rateLimit(const std::string& category)
+{
+    Epoch::ReadGuard guard;
+
+    auto limit = findClosest(configuration().load()->rateLimits, category);
+
+    if (limit == nullptr)
+    {
+        return RateLimit();
+    }
+
+    return *limit;
+}
+
+void Logger::Categories::setSuppressedSummaryInterval(std::chrono::milliseconds interval)
+{
+    m_summaryInterval = interval;
+
+    // Restarting summary interval
+    if (g_hasSuppressed)
+    {
+        g_nextSummary = steadyNanoseconds() + std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count();
+
+        summaryTimer().wake();
+    }
+    else
+    {
+        g_nextSummary = 0;
+    }
+}
+
+std::chrono::milliseconds Logger::Categories::suppressedSummaryInterval()
+{
+    return m_summaryInterval;
+}
+
+std::string Logger::Categories::typeCategory(const std::type_info& type)
+{
+    auto result = typeName(type);
+
+    auto position = result.find('<');
+
+    if (position != std::string::npos)
+    {
+        result.resize(position);
+    }
+
+    return result;
+}
+
+std::string Logger::Categories::typeName(const std::type_info& type)
+{
+    int status;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+    if (status != 0)
+    {
+        return type.name();
+    }
+
+    std::string result = demangled;
+
+    free(demangled);
+
+    return result;
+}
+
+template<typename T>
+static void storeChanged(std::atomic<T>& value, T newValue)
+{
+    // Site values are shared between threads, so
+    // not changed values are not written
+    if (value.load(std::memory_order_relaxed) != newValue)
+    {
+        value.store(newValue, std::memory_order_relaxed);
+    }
+}
+
+uint64_t Logger::CallSite::refresh(const std::string& category)
+{
+    auto state = resolve(category);
+
+    m_state.store(state, std::memory_order_relaxed);
+
+    return state;
+}
+
+uint64_t Logger::CallSite::categoryState(std::string_view category)
+{
+    auto& entry = t_categoryCache[
+        reinterpret_cast<uintptr_t>(this) / sizeof(CallSite) % t_categoryCache.size()
+    ];
+
+    if (entry.site == this &&
+        (entry.state >> 8) == Categories::generation() &&
+        entry.category == category)
+    {
+        return entry.state;
+    }
+
+    entry.site = this;
+    entry.category.assign(category.data(), category.size());
+    entry.state = resolve(entry.category);
+
+    return entry.state;
+}
+
+const std::string* Logger::CallSite::storeTypeName(const std::type_info& type)
+{
+    auto name = new std::string(Categories::typeName(type));
+
+    const std::string* expected = nullptr;
+
+    // Other thread could store name first
+    if (!m_typeName.compare_exchange_strong(expected, name, std::memory_order_acq_rel))
+    {
+        delete name;
+        return expected;
+    }
+
+    return name;
+}
+
+uint64_t Logger::CallSite::resolve(const std::string& category)
+{
+    // Generation is taken before lookup, so concurrent
+    // change will cause one more refresh
+    auto generation = Categories::generation();
+
+    // Messages, that logger doesn't accept,
+    // are skipped before stream creation
+    auto level = static_cast<uint64_t>(std::max(
+        Categories::level(category),
+        CurrentLogger::minimumErrorClass()
+    ));
+    auto recordLevel = level;
+
+    // Messages below output level are passed to flight recorder
+    if (FlightRecorder::isEnabled())
+    {
+        recordLevel = std::min(level, static_cast<uint64_t>(FlightRecorder::level()));
+    }
+
+    auto state = (generation << 8) | (recordLevel << 3) | level;
+
+    auto limit = Categories::rateLimit(category);
+
+    if (limit.messagesPerSecond > 0 || limit.sampleEvery > 1)
+    {
+        uint64_t interval = 0;
+
+        if (limit.messagesPerSecond > 0)
+        {
+            interval = static_cast<uint64_t>(1e9 / limit.messagesPerSecond);
+        }
+
+        storeChanged<uint64_t>(m_interval, interval);
+        storeChanged<uint64_t>(m_tolerance, interval * (std::max<uint32_t>(limit.burst, 1) - 1));
+        storeChanged<uint32_t>(m_sampleEvery, std::max<uint32_t>(limit.sampleEvery, 1));
+
+        state |= LimitedFlag;
+    }
+
+    return state;
+}
+
+bool Logger::CallSite::isAllowed()
+{
+    auto sampleEvery = m_sampleEvery.load(std::memory_order_relaxed);
+
+    if (sampleEvery > 1 &&
+        m_sampleCounter.fetch_add(1, std::memory_order_relaxed) % sampleEvery != 0)
+    {
+        suppress();
+        return false;
+    }
+
+    auto interval = m_interval.load(std::memory_order_relaxed);
+
+    if (interval == 0)
+    {
+        return true;
+    }
+
+    auto tolerance = m_tolerance.load(std::memory_order_relaxed);
+    auto now = static_cast<uint64_t>(steadyNanoseconds());
+    auto arrival = m_arrivalTime.load(std::memory_order_relaxed);
+
+    // Generic cell rate algorithm, equivalent of token bucket
+    // with one atomic value
+    while (true)
+    {
+        auto base = std::max(arrival, now);
+
+        if (base - now > tolerance)
+        {
+            suppress();
+            return false;
+        }
+
+        if (m_arrivalTime.compare_exchange_weak(arrival, base + interval, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+void Logger::CallSite::suppress()
+{
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+
+    bool expected = false;
+
+    if (!m_registered.load(std::memory_order_relaxed) &&
+        m_registered.compare_exchange_strong(expected, true))
+    {
+        m_next = g_limitedSites.load();
+
+        while (!g_limitedSites.compare_exchange_weak(m_next, this))
+        {
+        }
+    }
+
+    // Flag is set before interval start, so
+    // timer doesn't stop with suppressed messages
+    g_hasSuppressed.store(true);
+
+    // First suppression starts summary interval
+    int64_t next = 0;
+
+    if (g_nextSummary.load(std::memory_order_relaxed) == 0)
+    {
+        auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Categories::suppressedSummaryInterval()
+        ).count();
+
+        if (g_nextSummary.compare_exchange_strong(next, steadyNanoseconds() + interval))
+        {
+            summaryTimer().wake();
+        }
+    }
+}
+
+bool Logger::CallSite::takeSuppressedSummary(std::string& summary)
+{
+    if (!g_hasSuppressed.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    auto now = steadyNanoseconds();
+    auto next = g_nextSummary.load();
+
+    if (now < next)
+    {
+        return false;
+    }
+
+    auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Categories::suppressedSummaryInterval()
+    ).count();
+
+    // Only one thread makes summary
+    if (!g_nextSummary.compare_exchange_strong(next, now + interval))
+    {
+        return false;
+    }
+
+    g_hasSuppressed = false;
+
+    summary = "Suppressed messages:";
+
+    bool empty = true;
+
+    for (auto site = g_limitedSites.load(); site != nullptr; site = site->m_next)
+    {
+        auto suppressed = site->m_suppressed.exchange(0);
+
+        if (suppressed == 0)
+        {
+            continue;
+        }
+
+        auto filename = strrchr(site->m_filename, '/');
+
+        summary += ' ';
+        summary += (filename ? filename + 1 : site->m_filename);
+        summary += ':';
+        summary += std::to_string(site->m_line);
+        summary += " - ";
+        summary += std::to_string(suppressed);
+        summary += ';';
+
+        empty = false;
+    }
+
+    if (!empty)
+    {
+        summary.pop_back();
+    }
+
+    return !empty;
+}
@@ -0,0 +1,351 @@
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <stdexcept>
+#include "Clock.hpp"
+
+#ifdef OS_LINUX
+    #include <time.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #define ALOGGER_TSC
+    #include <cpuid.h>
+    #include <x86intrin.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Pair of TSC and realtime clock
+     * values, that are taken at one moment.
+     */
+    struct CalibrationPoint
+    {
+        uint64_t ticks;
+        int64_t nanoseconds;
+    };
+
+    // Calibration is published with sequence lock,
+    // odd sequence means, that it's being changed
+    std::atomic<uint64_t> g_sequence{0};
+    std::atomic<uint64_t> g_baseTicks{0};
+    std::atomic<int64_t> g_baseNanoseconds{0};
+    std::atomic<double> g_nanosecondsPerTick{0.0};
+    std::atomic<uint64_t> g_recalibrationTicks{0};
+    std::atomic_bool g_calibrated{false};
+
+    std::mutex g_calibrationMutex;
+
+    // Estimation with bigger difference means, that
+    // realtime clock was changed, not TSC frequency
+    constexpr double MaximumFrequencyChange = 0.01;
+
+    constexpr int64_t RecalibrationInterval = 1000000000;
+
+    int64_t systemNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+#ifdef OS_LINUX
+    int64_t clockNanoseconds(clockid_t clock)
+    {
+        timespec time{};
+        clock_gettime(clock, &time);
+
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+#endif
+
+    int64_t realtimeNanoseconds()
+    {
+#ifdef OS_LINUX
+        return clockNanoseconds(CLOCK_REALTIME);
+#else
+        return systemNanoseconds();
+#endif
+    }
+
+    uint64_t readTsc()
+    {
+#ifdef ALOGGER_TSC
+        return __rdtsc() & ~Logger::Clock::TscFlag;
+#else
+        return 0;
+#endif
+    }
+
+    bool isInvariantTsc()
+    {
+#ifdef ALOGGER_TSC
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        {
+            return false;
+        }
+
+        return (edx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    CalibrationPoint measure()
+    {
+        CalibrationPoint point{0, 0};
+        uint64_t bestWidth = ~0ULL;
+
+        // Narrowest of several attempts has
+        // least preemption error
+        for (int i = 0; i < 5; ++i)
+        {
+            auto before = readTsc();
+            auto nanoseconds = realtimeNanoseconds();
+            auto after = readTsc();
+
+            if (after - before < bestWidth)
+            {
+                bestWidth = after - before;
+                point.ticks = before + (after - before) / 2;
+                point.nanoseconds = nanoseconds;
+            }
+        }
+
+        return point;
+    }
+
+    void publish(const CalibrationPoint& point, double nanosecondsPerTick)
+    {
+        auto sequence = g_sequence.load(std::memory_order_relaxed);
+
+        g_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        g_baseTicks.store(point.ticks, std::memory_order_relaxed);
+        g_baseNanoseconds.store(point.nanoseconds, std::memory_order_relaxed);
+        g_nanosecondsPerTick.store(nanosecondsPerTick, std::memory_order_relaxed);
+        g_recalibrationTicks.store(
+            static_cast<uint64_t>(RecalibrationInterval / nanosecondsPerTick),
+            std::memory_order_relaxed
+        );
+
+        g_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void read(CalibrationPoint& point, double& nanosecondsPerTick, uint64_t& recalibrationTicks)
+    {
+        while (true)
+        {
+            auto sequence = g_sequence.load(std::memory_order_acquire);
+
+            if ((sequence & 1) != 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            point.ticks = g_baseTicks.load(std::memory_order_relaxed);
+            point.nanoseconds = g_baseNanoseconds.load(std::memory_order_relaxed);
+            nanosecondsPerTick = g_nanosecondsPerTick.load(std::memory_order_relaxed);
+            recalibrationTicks = g_recalibrationTicks.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (g_sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                return;
+            }
+        }
+    }
+
+    void calibrate()
+    {
+        std::unique_lock<std::mutex> lock(g_calibrationMutex);
+
+        if (g_calibrated)
+        {
+            return;
+        }
+
+        auto first = measure();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        auto second = measure();
+
+        publish(
+            second,
+            static_cast<double>(second.nanoseconds - first.nanoseconds) /
+            static_cast<double>(second.ticks - first.ticks)
+        );
+
+        g_calibrated = true;
+    }
+
+    void recalibrate()
+    {
+        // Converting threads does not wait each other
+        std::unique_lock<std::mutex> lock(g_calibrationMutex, std::try_to_lock);
+
+        if (!lock.owns_lock())
+        {
+            return;
+        }
+
+        CalibrationPoint previous{};
+        double nanosecondsPerTick = 0.0;
+        uint64_t recalibrationTicks = 0;
+
+        read(previous, nanosecondsPerTick, recalibrationTicks);
+
+        auto point = measure();
+
+        if (point.ticks - previous.ticks < recalibrationTicks)
+        {
+            return;
+        }
+
+        auto estimation = static_cast<double>(point.nanoseconds - previous.nanoseconds) /
+                          static_cast<double>(point.ticks - previous.ticks);
+
+        if (std::abs(estimation / nanosecondsPerTick - 1.0) < MaximumFrequencyChange)
+        {
+            nanosecondsPerTick = estimation;
+        }
+
+        publish(point, nanosecondsPerTick);
+    }
+
+    int64_t tscToNanoseconds(uint64_t ticks)
+    {
+        CalibrationPoint base{};
+        double nanosecondsPerTick = 0.0;
+        uint64_t recalibrationTicks = 0;
+
+        read(base, nanosecondsPerTick, recalibrationTicks);
+
+        auto delta = static_cast<int64_t>(ticks - base.ticks);
+
+        if (delta > static_cast<int64_t>(recalibrationTicks))
+        {
+            recalibrate();
+
+            read(base, nanosecondsPerTick, recalibrationTicks);
+
+            delta = static_cast<int64_t>(ticks - base.ticks);
+        }
+
+        return base.nanoseconds + std::llround(static_cast<double>(delta) * nanosecondsPerTick);
+    }
+}
+
+std::atomic<Logger::Clock::Source> Logger::Clock::m_source(Logger::Clock::Source::System);
+
+void Logger::Clock::setSource(Source source)
+{
+    if (!isAvailable(source))
+    {
+        throw std::runtime_error("Clock source is not available on this system.");
+    }
+
+    if (source == Source::Tsc)
+    {
+        calibrate();
+    }
+
+    m_source = source;
+}
+
+bool Logger::Clock::isAvailable(Source source)
+{
+    switch (source)
+    {
+    case Source::System:
+        return true;
+
+    case Source::Coarse:
+#ifdef OS_LINUX
+        return true;
+#else
+        return false;
+#endif
+
+    case Source::Tsc:
+        return isInvariantTsc();
+    }
+
+    return false;
+}
+
+uint64_t Logger::Clock::now()
+{
+    switch (source())
+    {
+    case Source::Tsc:
+        return readTsc() | TscFlag;
+
+#ifdef OS_LINUX
+    case Source::Coarse:
+        return static_cast<uint64_t>(clockNanoseconds(CLOCK_REALTIME_COARSE));
+#endif
+
+    default:
+        return static_cast<uint64_t>(systemNanoseconds());
+    }
+}
+
+std::chrono::system_clock::time_point Logger::Clock::toTimePoint(uint64_t timestamp)
+{
+    int64_t nanoseconds = 0;
+
+    if ((timestamp & TscFlag) != 0)
+    {
+        nanoseconds = tscToNanoseconds(timestamp & ~TscFlag);
+    }
+    else
+    {
+        nanoseconds = static_cast<int64_t>(timestamp);
+    }
+
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(nanoseconds)
+        )
+    );
+}
+
+Logger::Clock::Snapshot Logger::Clock::snapshot()
+{
+    Snapshot result;
+
+    if (!g_calibrated)
+    {
+        return result;
+    }
+
+    CalibrationPoint base{};
+    uint64_t recalibrationTicks = 0;
+
+    read(base, result.nanosecondsPerTick, recalibrationTicks);
+
+    result.baseTicks = base.ticks;
+    result.baseNanoseconds = base.nanoseconds;
+
+    return result;
+}
+
+int64_t Logger::Clock::toNanoseconds(uint64_t timestamp, const Snapshot& snapshot) noexcept
+{
+    if ((timestamp & TscFlag) == 0)
+    {
+        return static_cast<int64_t>(timestamp);
+    }
+
+    auto delta = static_cast<int64_t>((timestamp & ~TscFlag) - snapshot.baseTicks);
+
+    return snapshot.baseNanoseconds + static_cast<int64_t>(static_cast<double>(delta) * snapshot.nanosecondsPerTick);
+}
@@ -0,0 +1,131 @@
+#include <cstring>
+#include <vector>
+#include <stdexcept>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <SystemTools.h>
+#include "Collector.hpp"
+#include "Sinks/AbstractSink.hpp"
+
+Logger::Collector::Collector(std::string socketPath, Sinks::SinkPtr sink) :
+    m_socketPath(std::move(socketPath)),
+    m_sink(std::move(sink)),
+    m_fd(-1),
+    m_running(true),
+    m_receivedRecords(0),
+    m_thread()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (m_socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Collector socket path is too long.");
+    }
+
+    std::memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size() + 1);
+
+    m_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("Can't create collector socket: " + SystemTools::getLastErrorString());
+    }
+
+    // Socket of previous collector
+    unlink(m_socketPath.c_str());
+
+    if (bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        auto error = SystemTools::getLastErrorString();
+        ::close(m_fd);
+        throw std::runtime_error("Can't bind collector socket: " + error);
+    }
+
+    // Big receive buffer lets senders continue
+    // while collector writes batch
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    m_thread = std::thread(&Collector::receivingThread, this);
+}
+
+Logger::Collector::~Collector()
+{
+    m_running = false;
+
+    m_thread.join();
+
+    ::close(m_fd);
+    unlink(m_socketPath.c_str());
+
+    m_sink->flushRepeats();
+    m_sink->commit();
+}
+
+const std::string& Logger::Collector::socketPath() const
+{
+    return m_socketPath;
+}
+
+uint64_t Logger::Collector::receivedRecords() const
+{
+    return m_receivedRecords;
+}
+
+void Logger::Collector::receivingThread()
+{
+    std::vector<char> datagram(MaximumDatagramSize);
+
+    AbstractLogger::Message message;
+
+    while (m_running)
+    {
+        pollfd descriptor{m_fd, POLLIN, 0};
+
+        // Timeout is required to check running flag
+        if (poll(&descriptor, 1, 100) <= 0)
+        {
+            continue;
+        }
+
+        // Several datagrams are written as one batch
+        for (int i = 0; i < 64; ++i)
+        {
+            auto received = recv(m_fd, datagram.data(), datagram.size(), MSG_DONTWAIT);
+
+            if (received <= 0)
+            {
+                break;
+            }
+
+            std::size_t offset = 0;
+            auto size = static_cast<std::size_t>(received);
+
+            while (offset + RecordHeaderSize <= size)
+            {
+                uint32_t textSize = 0;
+                std::memcpy(&textSize, datagram.data() + offset, sizeof(textSize));
+
+                if (offset + RecordHeaderSize + textSize > size)
+                {
+                    break;
+                }
+
+                message.timePoint = std::chrono::system_clock::now();
+                message.errorClass = static_cast<AbstractLogger::ErrorClass>(datagram[offset + 4]);
+                message.message.assign(datagram.data() + offset + RecordHeaderSize, textSize);
+
+                m_sink->write(message, message.message);
+
+                ++m_receivedRecords;
+
+                offset += RecordHeaderSize + textSize;
+            }
+        }
+
+        m_sink->commit();
+    }
+}
@@ -1,14 +1,89 @@
+#include <algorithm>
+#include <mutex>
+#include <vector>
 #include "CurrentLogger.hpp"
-LoggerPtr CurrentLogger::m_logger;
+
+std::atomic<AbstractLogger*> CurrentLogger::m_current(nullptr);
+std::atomic<std::size_t> CurrentLogger::m_retiredCount(0);
+
+namespace
+{
+    // Every thread uses one pin counter of logger
+    std::atomic<std::size_t> g_nextPinCounter(0);
+    thread_local std::size_t t_pinCounter = g_nextPinCounter++;
+
+    // Generation in high bits, error class in low byte
+    std::atomic<uint64_t> g_minimumErrorClass(0);
+
+    /**
+     * @brief Replaced logger. Logger, that is
+     * replaced inside reader section, keeps
+     * retire generation until epoch is synchronized.
+     * 0 means, that epoch is synchronized.
+     */
+    struct RetiredLogger
+    {
+        LoggerPtr logger;
+        uint64_t generation;
+    };
+
+    /**
+     * @brief Replaced loggers, that are still
+     * pinned by references.
+     */
+    struct RetiredLoggers
+    {
+        std::mutex mutex;
+        std::vector<RetiredLogger> loggers;
+        uint64_t generation = 0;
+    };
+}
+
+static Epoch::Atomic<LoggerPtr>& owner()
+{
+    // Created on first use, logger can be
+    // set from static initialization
+    static Epoch::Atomic<LoggerPtr> owner;
+
+    return owner;
+}
+
+static RetiredLoggers& retired()
+{
+    static RetiredLoggers retired;
+
+    return retired;
+}
+
+CurrentLogger::Reference::Reference() :
+    m_logger(nullptr),
+    m_pin(nullptr)
+{
+    // Pin is taken inside section, so writer,
+    // that waited section end, sees it
+    Epoch::ReadGuard guard;
+
+    m_logger = CurrentLogger::current();
+
+    if (m_logger != nullptr)
+    {
+        m_pin = &m_logger->m_pins[t_pinCounter % AbstractLogger::PinCountersCount].value;
+        m_pin->fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
 LoggerPtr CurrentLogger::i()
 {
-    if (m_logger == nullptr)
+    Epoch::ReadGuard guard;
+
+    auto logger = *owner().load();
+
+    if (logger == nullptr)
     {
         throw std::runtime_error("There is no active logger");
     }
 
-    return m_logger;
+    return logger;
 }
 
 CurrentLogger::CurrentLogger()
@@ -16,7 +91,151 @@ CurrentLogger::CurrentLogger()
 
 }
 
+AbstractLogger::ErrorClass CurrentLogger::minimumErrorClass()
+{
+    // Generation is taken before calculation, so concurrent
+    // change will cause one more calculation
+    auto generation = Logger::Categories::generation();
+    auto cached = g_minimumErrorClass.load(std::memory_order_acquire);
+
+    if ((cached >> 8) == generation)
+    {
+        return static_cast<AbstractLogger::ErrorClass>(cached & 0xFF);
+    }
+
+    Reference reference;
+
+    auto result = AbstractLogger::ErrorClass::None;
+
+    if (reference.get() != nullptr)
+    {
+        result = reference.get()->minimumAcceptedErrorClass();
+    }
+
+    g_minimumErrorClass.store((generation << 8) | static_cast<uint64_t>(result), std::memory_order_release);
+
+    return result;
+}
+
 void CurrentLogger::setCurrentLogger(LoggerPtr logger)
 {
-    m_logger = std::move(logger);
+    LoggerPtr previous;
+
+    // Raw pointer is changed before previous owner
+    // is retired, so readers, that can see previous
+    // logger, are waited by epoch
+    owner().update(
+        [&logger, &previous](LoggerPtr& value)
+        {
+            m_current.store(logger.get());
+
+            previous = std::move(value);
+            value = std::move(logger);
+        }
+    );
+
+    // Call sites cache level of current logger
+    Logger::Categories::invalidate();
+
+    {
+        auto& state = retired();
+
+        std::unique_lock<std::mutex> lock(state.mutex);
+
+        if (previous != nullptr)
+        {
+            // Epoch is not synchronized inside reader
+            // section, so new pins are still possible
+            auto generation = Epoch::isReading() ? ++state.generation : 0;
+
+            state.loggers.push_back({std::move(previous), generation});
+
+            // Count is changed before pins are checked,
+            // so concurrent unpin either is seen here
+            // or sees count
+            m_retiredCount.store(state.loggers.size());
+        }
+    }
+
+    releaseRetired();
+}
+
+void CurrentLogger::releaseRetired()
+{
+    // Logger can't be released from reader section,
+    // it will be released on next unpin or replace
+    if (Epoch::isReading())
+    {
+        return;
+    }
+
+    auto& state = retired();
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    auto unsynchronized = std::any_of(
+        state.loggers.begin(),
+        state.loggers.end(),
+        [](const RetiredLogger& retiredLogger)
+        {
+            return retiredLogger.generation != 0;
+        }
+    );
+
+    if (unsynchronized)
+    {
+        // Loggers, retired after this point,
+        // are synchronized by next call
+        auto generation = state.generation;
+
+        // Readers can replace logger, so
+        // epoch is waited without lock
+        lock.unlock();
+        Epoch::synchronize();
+        lock.lock();
+
+        for (auto& retiredLogger : state.loggers)
+        {
+            if (retiredLogger.generation <= generation)
+            {
+                retiredLogger.generation = 0;
+            }
+        }
+    }
+
+    auto unpinned = std::partition(
+        state.loggers.begin(),
+        state.loggers.end(),
+        [](const RetiredLogger& retiredLogger)
+        {
+            return retiredLogger.generation != 0 || std::any_of(
+                std::begin(retiredLogger.logger->m_pins),
+                std::end(retiredLogger.logger->m_pins),
+                [](const AbstractLogger::PinCounter& counter)
+                {
+                    return counter.value.load() != 0;
+                }
+            );
+        }
+    );
+
+    std::vector<LoggerPtr> released;
+
+    std::for_each(
+        unpinned,
+        state.loggers.end(),
+        [&released](RetiredLogger& retiredLogger)
+        {
+            released.push_back(std::move(retiredLogger.logger));
+        }
+    );
+
+    state.loggers.erase(unpinned, state.loggers.end());
+
+    m_retiredCount.store(state.loggers.size());
+
+    lock.unlock();
+
+    // Loggers are destroyed outside of lock
+    released.clear();
 }
@@ -0,0 +1,109 @@
+#include <thread>
+#include <cstdint>
+#include "Epoch.hpp"
+
+namespace
+{
+    struct ReaderSlot
+    {
+        // Epoch, observed on section enter.
+        // 0 means, that reader is outside of section.
+        std::atomic<uint64_t> epoch{0};
+        std::atomic_bool used{false};
+        ReaderSlot* next = nullptr;
+    };
+
+    // Slots are never deleted, they are reused by new threads
+    std::atomic<ReaderSlot*> g_slots{nullptr};
+    std::atomic<uint64_t> g_epoch{1};
+
+    struct ThreadReader
+    {
+        ~ThreadReader()
+        {
+            if (slot != nullptr)
+            {
+                slot->used.store(false, std::memory_order_release);
+            }
+        }
+
+        ReaderSlot* slot = nullptr;
+        uint32_t nesting = 0;
+    };
+
+    thread_local ThreadReader t_reader;
+
+    ReaderSlot* acquireSlot()
+    {
+        for (auto slot = g_slots.load(); slot != nullptr; slot = slot->next)
+        {
+            bool expected = false;
+
+            if (!slot->used.load(std::memory_order_relaxed) &&
+                slot->used.compare_exchange_strong(expected, true))
+            {
+                return slot;
+            }
+        }
+
+        auto slot = new ReaderSlot();
+        slot->used = true;
+        slot->next = g_slots.load();
+
+        while (!g_slots.compare_exchange_weak(slot->next, slot))
+        {
+        }
+
+        return slot;
+    }
+}
+
+Epoch::ReadGuard::ReadGuard()
+{
+    if (t_reader.nesting++ != 0)
+    {
+        return;
+    }
+
+    if (t_reader.slot == nullptr)
+    {
+        t_reader.slot = acquireSlot();
+    }
+
+    t_reader.slot->epoch.store(g_epoch.load());
+}
+
+Epoch::ReadGuard::~ReadGuard()
+{
+    if (--t_reader.nesting != 0)
+    {
+        return;
+    }
+
+    t_reader.slot->epoch.store(0, std::memory_order_release);
+}
+
+void Epoch::synchronize()
+{
+    auto target = g_epoch.fetch_add(1);
+
+    for (auto slot = g_slots.load(); slot != nullptr; slot = slot->next)
+    {
+        while (true)
+        {
+            auto epoch = slot->epoch.load();
+
+            if (epoch == 0 || epoch > target)
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool Epoch::isReading()
+{
+    return t_reader.nesting != 0;
+}
@@ -0,0 +1,66 @@
+#include <charconv>
+#include "Fields.hpp"
+#include "Stream.hpp"
+
+static void appendValue(std::string& result, const Logger::Field& field)
+{
+    char buffer[32];
+    std::to_chars_result converted{buffer, std::errc()};
+
+    switch (field.type)
+    {
+    case Logger::Field::Type::Int:
+        converted = std::to_chars(buffer, buffer + sizeof(buffer), field.intValue);
+        break;
+    case Logger::Field::Type::UInt:
+        converted = std::to_chars(buffer, buffer + sizeof(buffer), field.uintValue);
+        break;
+    case Logger::Field::Type::Double:
+        converted = std::to_chars(buffer, buffer + sizeof(buffer), field.doubleValue);
+        break;
+    case Logger::Field::Type::Bool:
+        result.append(field.boolValue ? "true" : "false");
+        return;
+    case Logger::Field::Type::String:
+        result.append(field.string);
+        return;
+    }
+
+    result.append(buffer, converted.ptr);
+}
+
+void Logger::addField(std::ostream& stream, Logger::Field field)
+{
+    auto buffer = dynamic_cast<Loggers::StreamBuffer*>(stream.rdbuf());
+
+    if (buffer != nullptr)
+    {
+        buffer->addField(std::move(field));
+        return;
+    }
+
+    std::string result;
+
+    result.append(field.key);
+    result.push_back('=');
+
+    appendValue(result, field);
+
+    stream << result;
+}
+
+void Logger::appendFields(std::string& result, const Logger::Fields& fields)
+{
+    for (auto&& field : fields)
+    {
+        if (&field != &fields.front())
+        {
+            result.push_back(' ');
+        }
+
+        result.append(field.key);
+        result.push_back('=');
+
+        appendValue(result, field);
+    }
+}
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include "FlightRecorder.hpp"
+#include "Categories.hpp"
+
+namespace
+{
+    /**
+     * @brief Binary form of recorded message.
+     * Only raw values and pointers to static
+     * strings are stored.
+     */
+    struct Record
+    {
+        // Raw `Logger::Clock` timestamp
+        uint64_t timestamp;
+        const char* filename;
+        std::thread::id thread;
+        int line;
+        AbstractLogger::ErrorClass errorClass;
+        uint16_t contextSize;
+        uint16_t messageSize;
+        char text[Logger::FlightRecorder::RecordTextSize];
+    };
+
+    static_assert(std::is_trivially_copyable<Record>::value, "Record has to be trivially copyable");
+
+    struct Slot
+    {
+        // Odd value means, that record is being written
+        std::atomic<uint32_t> sequence{0};
+        Record record;
+    };
+
+    struct Ring
+    {
+        std::atomic<uint64_t> head{0};
+        std::atomic_bool used{false};
+        Ring* next = nullptr;
+        Slot slots[Logger::FlightRecorder::RingCapacity];
+    };
+
+    // Rings are never deleted, they are reused by new threads,
+    // so history of finished threads is kept
+    std::atomic<Ring*> g_rings{nullptr};
+
+    std::atomic<AbstractLogger::ErrorClass> g_level{AbstractLogger::ErrorClass::Debug};
+    std::atomic<AbstractLogger::ErrorClass> g_triggerLevel{AbstractLogger::ErrorClass::Error};
+    std::atomic<std::chrono::milliseconds> g_history{std::chrono::seconds(10)};
+
+    // Time of last taken history in nanoseconds
+    std::atomic<int64_t> g_takenUntil{0};
+
+    struct ThreadRing
+    {
+        ~ThreadRing()
+        {
+            if (ring != nullptr)
+            {
+                ring->used.store(false, std::memory_order_release);
+            }
+        }
+
+        Ring* ring = nullptr;
+    };
+
+    thread_local ThreadRing t_ring;
+
+    Ring* acquireRing()
+    {
+        for (auto ring = g_rings.load(); ring != nullptr; ring = ring->next)
+        {
+            bool expected = false;
+
+            if (!ring->used.load(std::memory_order_relaxed) &&
+                ring->used.compare_exchange_strong(expected, true))
+            {
+                return ring;
+            }
+        }
+
+        auto ring = new Ring();
+        ring->used = true;
+        ring->next = g_rings.load();
+
+        while (!g_rings.compare_exchange_weak(ring->next, ring))
+        {
+        }
+
+        return ring;
+    }
+
+    int64_t systemNanoseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    std::size_t copyText(char* destination, std::size_t capacity, std::string_view text)
+    {
+        auto size = std::min(capacity, text.size());
+
+        std::memcpy(destination, text.data(), size);
+
+        return size;
+    }
+}
+
+std::atomic_bool Logger::FlightRecorder::m_enabled(false);
+
+void Logger::FlightRecorder::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+
+    // Call sites has to pass recorded levels
+    ++Categories::m_generation;
+}
+
+void Logger::FlightRecorder::setLevel(AbstractLogger::ErrorClass errorClass)
+{
+    g_level = errorClass;
+
+    ++Categories::m_generation;
+}
+
+AbstractLogger::ErrorClass Logger::FlightRecorder::level()
+{
+    return g_level;
+}
+
+void Logger::FlightRecorder::setTriggerLevel(AbstractLogger::ErrorClass errorClass)
+{
+    g_triggerLevel = errorClass;
+
+    // Trigger messages has to reach logger
+    ++Categories::m_generation;
+}
+
+AbstractLogger::ErrorClass Logger::FlightRecorder::triggerLevel()
+{
+    return g_triggerLevel;
+}
+
+void Logger::FlightRecorder::setHistory(std::chrono::milliseconds history)
+{
+    g_history = history;
+}
+
+std::chrono::milliseconds Logger::FlightRecorder::history()
+{
+    return g_history;
+}
+
+void Logger::FlightRecorder::record(AbstractLogger::ErrorClass errorClass,
+                                    const char* filename,
+                                    int line,
+                                    std::thread::id thread,
+                                    std::string_view classname,
+                                    const char* function,
+                                    std::string_view message)
+{
+    if (t_ring.ring == nullptr)
+    {
+        t_ring.ring = acquireRing();
+    }
+
+    auto ring = t_ring.ring;
+
+    // Ring has only one writer, so head is not contended
+    auto position = ring->head.load(std::memory_order_relaxed);
+    auto& slot = ring->slots[position % RingCapacity];
+
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& record = slot.record;
+
+    record.timestamp = Logger::Clock::now();
+    record.filename = filename;
+    record.thread = thread;
+    record.line = line;
+    record.errorClass = errorClass;
+
+    // Context takes at most half of text
+    std::size_t contextSize = 0;
+
+    if (!classname.empty())
+    {
+        contextSize += copyText(record.text, RecordTextSize / 2, classname);
+        contextSize += copyText(record.text + contextSize, RecordTextSize / 2 - contextSize, "::");
+    }
+
+    contextSize += copyText(record.text + contextSize, RecordTextSize / 2 - contextSize, function);
+
+    record.contextSize = static_cast<uint16_t>(contextSize);
+    record.messageSize = static_cast<uint16_t>(
+        copyText(record.text + contextSize, RecordTextSize - contextSize, message)
+    );
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+
+    ring->head.store(position + 1, std::memory_order_release);
+}
+
+void Logger::FlightRecorder::takeHistory(std::vector<AbstractLogger::Message>& messages)
+{
+    messages.clear();
+
+    auto now = systemNanoseconds();
+
+    auto oldest = std::max(
+        now - std::chrono::duration_cast<std::chrono::nanoseconds>(history()).count(),
+        g_takenUntil.exchange(now)
+    );
+
+    Record record;
+
+    for (auto ring = g_rings.load(); ring != nullptr; ring = ring->next)
+    {
+        auto head = ring->head.load(std::memory_order_acquire);
+        auto position = head > RingCapacity ? head - RingCapacity : 0;
+
+        for (; position < head; ++position)
+        {
+            auto& slot = ring->slots[position % RingCapacity];
+
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+            if (sequence & 1u)
+            {
+                continue;
+            }
+
+            std::memcpy(&record, &slot.record, sizeof(Record));
+
+            // Record was overwritten while copying
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            {
+                continue;
+            }
+
+            auto timePoint = Logger::Clock::toTimePoint(record.timestamp);
+
+            auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                timePoint.time_since_epoch()
+            ).count();
+
+            if (time <= oldest || time > now)
+            {
+                continue;
+            }
+
+            AbstractLogger::Message message;
+
+            message.timePoint = timePoint;
+            message.errorClass = record.errorClass;
+            message.thread = record.thread;
+            message.filename = record.filename;
+            message.line = record.line;
+            message.context.assign(record.text, record.contextSize);
+            message.message.assign(record.text + record.contextSize, record.messageSize);
+            message.history = true;
+
+            messages.push_back(std::move(message));
+        }
+    }
+
+    std::stable_sort(
+        messages.begin(),
+        messages.end(),
+        [](const AbstractLogger::Message& lhs, const AbstractLogger::Message& rhs)
+        {
+            return lhs.timePoint < rhs.timePoint;
+        }
+    );
+}
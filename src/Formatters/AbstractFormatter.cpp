@@ -0,0 +1,6 @@
+#include "Formatters/AbstractFormatter.hpp"
+
+bool Formatters::AbstractFormatter::isEquivalent(const Formatters::AbstractFormatter& other) const
+{
+    return this == &other;
+}
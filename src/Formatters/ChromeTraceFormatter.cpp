@@ -0,0 +1,129 @@
+#include <charconv>
+#include <functional>
+#include "Formatters/ChromeTraceFormatter.hpp"
+#include "Formatters/JsonLinesFormatter.hpp"
+
+#ifdef OS_LINUX
+    #include <unistd.h>
+#endif
+#ifdef OS_WINDOWS
+    #include <process.h>
+#endif
+
+template<typename T>
+static void appendNumber(std::string& result, T value)
+{
+    char buffer[32];
+
+    auto converted = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+    result.append(buffer, converted.ptr);
+}
+
+/**
+ * @brief Trace time is in microseconds, nanoseconds
+ * are written as fractional part.
+ */
+static void appendMicroseconds(std::string& result, uint64_t nanoseconds)
+{
+    appendNumber(result, nanoseconds / 1000);
+
+    auto fractional = static_cast<int>(nanoseconds % 1000);
+
+    result.push_back('.');
+    result.push_back(static_cast<char>('0' + fractional / 100));
+    result.push_back(static_cast<char>('0' + fractional / 10 % 10));
+    result.push_back(static_cast<char>('0' + fractional % 10));
+}
+
+static const char* errorClassName(AbstractLogger::ErrorClass errorClass)
+{
+    switch (errorClass)
+    {
+    case AbstractLogger::ErrorClass::Unknown:
+        return "Unknown";
+    case AbstractLogger::ErrorClass::Debug:
+        return "Debug";
+    case AbstractLogger::ErrorClass::Info:
+        return "Info";
+    case AbstractLogger::ErrorClass::Warning:
+        return "Warning";
+    case AbstractLogger::ErrorClass::Error:
+        return "Error";
+    case AbstractLogger::ErrorClass::None:
+        return "None";
+    }
+
+    return "Unknown";
+}
+
+std::string Formatters::ChromeTraceFormatter::format(const AbstractLogger::Message& message) const
+{
+    std::string result;
+    result.reserve(160 + message.message.size() + message.context.size());
+
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        message.time().time_since_epoch()
+    ).count();
+
+    result.append("{\"name\":");
+    JsonLinesFormatter::appendString(result, message.message);
+
+    result.append(",\"cat\":");
+    JsonLinesFormatter::appendString(result, message.context);
+
+    result.append(message.span ? ",\"ph\":\"X\"" : ",\"ph\":\"i\",\"s\":\"t\"");
+
+    result.append(",\"ts\":");
+    appendMicroseconds(result, time > 0 ? static_cast<uint64_t>(time) : 0);
+
+    if (message.span)
+    {
+        result.append(",\"dur\":");
+        appendMicroseconds(result, message.spanDuration);
+    }
+
+    result.append(",\"pid\":");
+    appendNumber(result, processId());
+
+    result.append(",\"tid\":");
+    appendNumber(result, threadId(message.thread));
+
+    result.append(",\"args\":{\"file\":");
+    JsonLinesFormatter::appendString(result, message.filename != nullptr ? message.filename : "");
+
+    result.append(",\"line\":");
+    appendNumber(result, message.line);
+
+    if (!message.span)
+    {
+        result.append(",\"level\":\"");
+        result.append(errorClassName(message.errorClass));
+        result.push_back('"');
+    }
+
+    result.append("}}");
+
+    return result;
+}
+
+bool Formatters::ChromeTraceFormatter::isEquivalent(const Formatters::AbstractFormatter& other) const
+{
+    return dynamic_cast<const ChromeTraceFormatter*>(&other) != nullptr;
+}
+
+uint32_t Formatters::ChromeTraceFormatter::threadId(std::thread::id thread)
+{
+    // Trace viewers expect number
+    return static_cast<uint32_t>(std::hash<std::thread::id>()(thread));
+}
+
+uint32_t Formatters::ChromeTraceFormatter::processId()
+{
+#ifdef OS_LINUX
+    return static_cast<uint32_t>(getpid());
+#endif
+#ifdef OS_WINDOWS
+    return static_cast<uint32_t>(_getpid());
+#endif
+}
@@ -0,0 +1,201 @@
+#include <charconv>
+#include <cmath>
+#include <ctime>
+#include "Formatters/JsonLinesFormatter.hpp"
+#include "Formatters/Sanitizer.hpp"
+#include "Threads.hpp"
+#include "Backtrace.hpp"
+
+static const char* errorClassName(AbstractLogger::ErrorClass errorClass)
+{
+    switch (errorClass)
+    {
+    case AbstractLogger::ErrorClass::Unknown:
+        return "Unknown";
+    case AbstractLogger::ErrorClass::Debug:
+        return "Debug";
+    case AbstractLogger::ErrorClass::Info:
+        return "Info";
+    case AbstractLogger::ErrorClass::Warning:
+        return "Warning";
+    case AbstractLogger::ErrorClass::Error:
+        return "Error";
+    case AbstractLogger::ErrorClass::None:
+        return "None";
+    }
+
+    return "Unknown";
+}
+
+template<typename T>
+static void appendNumber(std::string& result, T value)
+{
+    char buffer[32];
+
+    auto converted = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+    result.append(buffer, converted.ptr);
+}
+
+static void appendDigits(std::string& result, int value, int width)
+{
+    char buffer[8];
+
+    for (int i = width - 1; i >= 0; --i)
+    {
+        buffer[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+
+    result.append(buffer, static_cast<std::size_t>(width));
+}
+
+static void appendTime(std::string& result, std::chrono::system_clock::time_point timePoint)
+{
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        timePoint.time_since_epoch()
+    ).count() % 1000;
+
+    auto time = std::chrono::system_clock::to_time_t(timePoint);
+    std::tm utc{};
+
+#ifdef OS_LINUX
+    gmtime_r(&time, &utc);
+#endif
+#ifdef OS_WINDOWS
+    gmtime_s(&utc, &time);
+#endif
+
+    result.push_back('"');
+    appendDigits(result, utc.tm_year + 1900, 4);
+    result.push_back('-');
+    appendDigits(result, utc.tm_mon + 1, 2);
+    result.push_back('-');
+    appendDigits(result, utc.tm_mday, 2);
+    result.push_back('T');
+    appendDigits(result, utc.tm_hour, 2);
+    result.push_back(':');
+    appendDigits(result, utc.tm_min, 2);
+    result.push_back(':');
+    appendDigits(result, utc.tm_sec, 2);
+    result.push_back('.');
+    appendDigits(result, static_cast<int>(ms), 3);
+    result.append("Z\"");
+}
+
+void Formatters::JsonLinesFormatter::appendString(std::string& result, std::string_view value)
+{
+    result.push_back('"');
+
+    Sanitizer::append(result, value, Sanitizer::Mode::Json);
+
+    result.push_back('"');
+}
+
+std::string Formatters::JsonLinesFormatter::format(const AbstractLogger::Message& message) const
+{
+    std::string result;
+    result.reserve(128 + message.message.size() + message.context.size());
+
+    result.append("{\"time\":");
+    appendTime(result, message.time());
+
+    result.append(",\"level\":\"");
+    result.append(errorClassName(message.errorClass));
+
+    result.append("\",\"file\":");
+    appendString(result, message.filename != nullptr ? message.filename : "");
+
+    result.append(",\"line\":");
+    appendNumber(result, message.line);
+
+    auto& thread = Logger::Threads::render(message.thread);
+
+    result.append(",\"thread\":\"");
+    result.append(thread.id);
+    result.append("\"");
+
+    // Unnamed threads have id instead of name
+    if (thread.name != thread.id)
+    {
+        result.append(",\"thread_name\":");
+        appendString(result, thread.name);
+    }
+
+    result.append(",\"context\":");
+    appendString(result, message.context);
+
+    result.append(",\"message\":");
+    appendString(result, message.message);
+
+    if (!message.fields.empty())
+    {
+        result.append(",\"fields\":{");
+
+        for (auto&& field : message.fields)
+        {
+            if (&field != &message.fields.front())
+            {
+                result.push_back(',');
+            }
+
+            appendString(result, field.key);
+            result.push_back(':');
+
+            switch (field.type)
+            {
+            case Logger::Field::Type::Int:
+                appendNumber(result, field.intValue);
+                break;
+            case Logger::Field::Type::UInt:
+                appendNumber(result, field.uintValue);
+                break;
+            case Logger::Field::Type::Double:
+                // JSON has no infinity and NaN
+                if (std::isfinite(field.doubleValue))
+                {
+                    appendNumber(result, field.doubleValue);
+                }
+                else
+                {
+                    result.append("null");
+                }
+                break;
+            case Logger::Field::Type::Bool:
+                result.append(field.boolValue ? "true" : "false");
+                break;
+            case Logger::Field::Type::String:
+                appendString(result, field.string);
+                break;
+            }
+        }
+
+        result.push_back('}');
+    }
+
+    if (!message.backtrace.empty())
+    {
+        result.append(",\"backtrace\":[");
+
+        for (std::size_t i = 0; i < message.backtrace.size(); ++i)
+        {
+            if (i != 0)
+            {
+                result.push_back(',');
+            }
+
+            appendString(result, Logger::Backtrace::symbolize(message.backtrace[i]));
+        }
+
+        result.push_back(']');
+    }
+
+    result.push_back('}');
+
+    return result;
+}
+
+bool Formatters::JsonLinesFormatter::isEquivalent(const Formatters::AbstractFormatter& other) const
+{
+    return dynamic_cast<const JsonLinesFormatter*>(&other) != nullptr;
+}
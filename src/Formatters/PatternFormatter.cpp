@@ -0,0 +1,256 @@
+#include <sstream>
+#include <map>
+#include <ctime>
+#include "Formatters/PatternFormatter.hpp"
+#include "Formatters/Sanitizer.hpp"
+#include "Threads.hpp"
+#include "Backtrace.hpp"
+
+Formatters::PatternFormatter::PatternFormatter(std::string pattern, bool sanitize) :
+    m_formatString(std::move(pattern)),
+    m_formatCache(),
+    m_sanitize(sanitize)
+{
+    cacheFormat();
+}
+
+const std::string& Formatters::PatternFormatter::pattern() const
+{
+    return m_formatString;
+}
+
+bool Formatters::PatternFormatter::sanitizationEnabled() const
+{
+    return m_sanitize;
+}
+
+bool Formatters::PatternFormatter::isEquivalent(const Formatters::AbstractFormatter& other) const
+{
+    if (this == &other)
+    {
+        return true;
+    }
+
+    auto patternFormatter = dynamic_cast<const PatternFormatter*>(&other);
+
+    return patternFormatter != nullptr &&
+           patternFormatter->m_formatString == m_formatString &&
+           patternFormatter->m_sanitize == m_sanitize;
+}
+
+void Formatters::PatternFormatter::writeText(std::ostream& ss, std::string_view text) const
+{
+    if (!m_sanitize)
+    {
+        ss << text;
+        return;
+    }
+
+    static thread_local std::string sanitized;
+
+    sanitized.clear();
+    Sanitizer::append(sanitized, text, Sanitizer::Mode::Text);
+
+    ss << sanitized;
+}
+
+std::string Formatters::PatternFormatter::format(const AbstractLogger::Message& message) const
+{
+    // Stream is thread local, because message can be
+    // formatted by several threads simultaneously.
+    static thread_local std::stringstream ss;
+
+    ss.str(std::string());
+
+    for (auto&& cache : m_formatCache)
+    {
+        switch (cache.type)
+        {
+        case FormatCache::Type::DateTime:
+        {
+            auto timePoint = message.time();
+
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                timePoint.time_since_epoch()
+            );
+
+            auto fractional_seconds = ms.count() % 1000;
+
+            auto time = std::chrono::system_clock::to_time_t(timePoint);
+            std::tm nowValue{};
+            std::tm* now = &nowValue;
+
+#ifdef OS_LINUX
+            localtime_r(&time, now);
+#endif
+#ifdef OS_WINDOWS
+            localtime_s(now, &time);
+#endif
+
+            ss << (now->tm_year + 1900) << '-';
+
+            ss.width(2);
+            ss.fill('0');
+            ss << (now->tm_mon + 1)     << '-';
+
+            ss.width(2);
+            ss.fill('0');
+            ss <<  now->tm_mday         << ' ';
+
+            ss.width(2);
+            ss.fill('0');
+            ss <<  now->tm_hour         << ':';
+
+            ss.width(2);
+            ss.fill('0');
+            ss <<  now->tm_min          << ':';
+
+            ss.width(2);
+            ss.fill('0');
+            ss <<  now->tm_sec          << ',';
+
+            ss.width(3);
+            ss <<  fractional_seconds;
+            break;
+        }
+        case FormatCache::Type::FileName:
+            ss << message.filename;
+            break;
+        case FormatCache::Type::Line:
+            ss << message.line;
+            break;
+        case FormatCache::Type::Thread:
+            ss << Logger::Threads::render(message.thread).id;
+            break;
+        case FormatCache::Type::ThreadName:
+            ss << Logger::Threads::render(message.thread).name;
+            break;
+        case FormatCache::Type::Context:
+            writeText(ss, message.context);
+            break;
+        case FormatCache::Type::ErrorClass:
+        {
+            switch (message.errorClass)
+            {
+            case AbstractLogger::ErrorClass::Unknown:
+                ss << "Unknown";
+                break;
+            case AbstractLogger::ErrorClass::Debug:
+                ss << "Debug";
+                break;
+            case AbstractLogger::ErrorClass::Info:
+                ss << "Info";
+                break;
+            case AbstractLogger::ErrorClass::Warning:
+                ss << "Warning";
+                break;
+            case AbstractLogger::ErrorClass::Error:
+                ss << "Error";
+                break;
+            case AbstractLogger::ErrorClass::None:
+                // Messages with 'None' error class are
+                // dropped by logger, before formatting.
+                return std::string();
+            }
+            break;
+        }
+        case FormatCache::Type::Message:
+            writeText(ss, message.message);
+            break;
+        case FormatCache::Type::Fields:
+        {
+            static thread_local std::string fields;
+
+            fields.clear();
+            Logger::appendFields(fields, message.fields);
+
+            writeText(ss, fields);
+            break;
+        }
+        case FormatCache::Type::String:
+            ss << cache.value;
+            break;
+        }
+    }
+
+    // Stack trace is written after message,
+    // one frame per line
+    for (std::size_t i = 0; i < message.backtrace.size(); ++i)
+    {
+        ss << "\n    #" << i << ' ' << Logger::Backtrace::symbolize(message.backtrace[i]);
+    }
+
+    return ss.str();
+}
+
+void Formatters::PatternFormatter::cacheFormat()
+{
+    const std::map<std::string_view, FormatCache::Type> variables = {
+        {"%{DATETIME}",    FormatCache::Type::DateTime  },
+        {"%{FILENAME}",    FormatCache::Type::FileName  },
+        {"%{LINE}",        FormatCache::Type::Line      },
+        {"%{CONTEXT}",     FormatCache::Type::Context   },
+        {"%{ERROR_CLASS}", FormatCache::Type::ErrorClass},
+        {"%{MESSAGE}",     FormatCache::Type::Message   },
+        {"%{THREAD}",      FormatCache::Type::Thread    },
+        {"%{THREAD_NAME}", FormatCache::Type::ThreadName},
+        {"%{FIELDS}",      FormatCache::Type::Fields    },
+    };
+
+    m_formatCache.clear();
+
+    std::string::size_type index = 0;
+    std::string::size_type endIndex = 0;
+    std::string::size_type previousString = 0;
+    auto mapIterator = variables.end();
+
+    while (index < m_formatString.size())
+    {
+        // Searching for `%{` symbol
+        index = m_formatString.find("%{", index);
+
+        // If was not found, string is finished.
+        if (index == std::string::npos)
+        {
+            m_formatCache.emplace_back(
+                FormatCache::Type::String,
+                std::string_view(m_formatString.c_str() + previousString, m_formatString.size() - previousString)
+            );
+
+            break;
+        }
+
+        // Searching for close symbol
+        endIndex = m_formatString.find('}', index);
+
+        // Searching for founded expected variable
+        std::string_view subString(m_formatString.c_str() + index, (endIndex + 1) - index);
+
+        mapIterator = variables.find(subString);
+
+        // If it's not variable
+        if (mapIterator == variables.end())
+        {
+            index += 1;
+            continue;
+        }
+
+        // If it's variable, pushing string before,
+        // if it's not empty. Pushing variable
+        if (previousString < index)
+        {
+            m_formatCache.emplace_back(
+                    FormatCache::Type::String,
+                    std::string_view(m_formatString.c_str() + previousString, index - previousString)
+            );
+        }
+
+        // Pushing variable and moving iterators
+        m_formatCache.emplace_back(
+                mapIterator->second
+        );
+
+        previousString = endIndex + 1; // size of '}' = 1
+        index = endIndex + 1;
+    }
+}
@@ -0,0 +1,533 @@
+#include <atomic>
+#include <cstdint>
+#include "Formatters/Sanitizer.hpp"
+
+// Kernels use GCC builtins for dispatching
+#if defined(__SSE2__) && defined(__GNUC__)
+    #define ALOGGER_SSE2
+    #include <emmintrin.h>
+
+    #if defined(__x86_64__)
+        #define ALOGGER_AVX2
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace
+{
+    using FindFunction = std::size_t (*)(const char*, std::size_t, bool);
+
+    bool isSpecial(unsigned char symbol, bool json)
+    {
+        return symbol < 0x20 ||
+               symbol >= 0x7F ||
+               (json && (symbol == '"' || symbol == '\\'));
+    }
+
+    std::size_t findScalar(const char* data, std::size_t size, bool json)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (isSpecial(static_cast<unsigned char>(data[i]), json))
+            {
+                return i;
+            }
+        }
+
+        return size;
+    }
+
+#ifdef ALOGGER_SSE2
+    std::size_t findSse2(const char* data, std::size_t size, bool json)
+    {
+        if (size < 16)
+        {
+            return findScalar(data, size, json);
+        }
+
+        // Bytes >= 0x80 are negative, so one signed
+        // comparison finds control and non ASCII bytes
+        const auto space = _mm_set1_epi8(0x20);
+        const auto del = _mm_set1_epi8(0x7F);
+        const auto quote = _mm_set1_epi8(json ? '"' : 0x7F);
+        const auto backslash = _mm_set1_epi8(json ? '\\' : 0x7F);
+
+        auto specialMask = [&](std::size_t offset)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+
+            auto special = _mm_or_si128(
+                _mm_or_si128(_mm_cmplt_epi8(block, space), _mm_cmpeq_epi8(block, del)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash))
+            );
+
+            return static_cast<unsigned>(_mm_movemask_epi8(special));
+        };
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= size; i += 16)
+        {
+            auto mask = specialMask(i);
+
+            if (mask != 0)
+            {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+
+        // Tail is checked with last block, that
+        // overlaps already checked bytes
+        if (i < size)
+        {
+            auto mask = specialMask(size - 16) >> (16 - (size - i));
+
+            if (mask != 0)
+            {
+                return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+        }
+
+        return size;
+    }
+#endif
+
+    /**
+     * @brief Function for getting start of UTF-8
+     * sequence, that is not finished before position.
+     * Text before position has to be valid UTF-8.
+     * @return Start of sequence or position.
+     */
+    std::size_t sequenceStart(const char* data, std::size_t position)
+    {
+        for (std::size_t i = 1; i <= 3 && i <= position; ++i)
+        {
+            auto symbol = static_cast<unsigned char>(data[position - i]);
+
+            // Continuation byte
+            if ((symbol & 0xC0u) == 0x80)
+            {
+                continue;
+            }
+
+            std::size_t length = symbol >= 0xF0 ? 4 : symbol >= 0xE0 ? 3 : symbol >= 0xC0 ? 2 : 1;
+
+            return length > i ? position - i : position;
+        }
+
+        return position;
+    }
+
+#ifdef ALOGGER_AVX2
+    // Flags of UTF-8 errors in pair of bytes, they are
+    // found by lookup of nibbles of both bytes
+    constexpr char TooShort = 1 << 0;   // 11______ 0_______, 11______ 11______
+    constexpr char TooLong = 1 << 1;    // 0_______ 10______
+    constexpr char Overlong3 = 1 << 2;  // 11100000 100_____
+    constexpr char TooLarge = 1 << 3;   // 11110100 1001____, 11110100 101_____ and bigger leads
+    constexpr char Surrogate = 1 << 4;  // 11101101 101_____
+    constexpr char Overlong2 = 1 << 5;  // 1100000_ 10______
+    constexpr char TooLarge1000 = 1 << 6; // 11110101 1000____ and bigger leads
+    constexpr char Overlong4 = 1 << 6;  // 11110000 1000____
+    constexpr char TwoContinuations = static_cast<char>(1 << 7); // 10______ 10______
+    constexpr char Carry = TooShort | TooLong | TwoContinuations;
+
+    template<int Count>
+    __attribute__((target("avx2")))
+    __m256i previousBytes(__m256i block, __m256i previous)
+    {
+        // Last bytes of previous block are shifted into block
+        return _mm256_alignr_epi8(block, _mm256_permute2x128_si256(previous, block, 0x21), 16 - Count);
+    }
+
+    /**
+     * @brief Function for checking UTF-8 of block. It's
+     * lookup algorithm of Keiser and Lemire: errors of
+     * two byte combinations are found by three table
+     * lookups, continuations of 3 and 4 byte sequences
+     * are checked with bytes 2 and 3 positions back.
+     * @param block Block.
+     * @param previous Previous block.
+     * @return Non zero bytes, if block has errors.
+     */
+    __attribute__((target("avx2")))
+    __m256i utf8Errors(__m256i block, __m256i previous)
+    {
+        const auto firstHighTable = _mm256_setr_epi8(
+            TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+            TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+            TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate,
+            TooShort | TooLarge | TooLarge1000 | Overlong4,
+            TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+            TwoContinuations, TwoContinuations, TwoContinuations, TwoContinuations,
+            TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate,
+            TooShort | TooLarge | TooLarge1000 | Overlong4
+        );
+
+        const auto firstLowTable = _mm256_setr_epi8(
+            Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry,
+            Carry | TooLarge, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000 | Surrogate,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry,
+            Carry | TooLarge, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000 | Surrogate,
+            Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000
+        );
+
+        const auto secondHighTable = _mm256_setr_epi8(
+            TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+            TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+            TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+            TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+            TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+            TooShort, TooShort, TooShort, TooShort,
+            TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+            TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge1000 | Overlong4,
+            TooLong | Overlong2 | TwoContinuations | Overlong3 | TooLarge,
+            TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+            TooLong | Overlong2 | TwoContinuations | Surrogate | TooLarge,
+            TooShort, TooShort, TooShort, TooShort
+        );
+
+        const auto nibble = _mm256_set1_epi8(0x0F);
+
+        auto previous1 = previousBytes<1>(block, previous);
+
+        auto special = _mm256_and_si256(
+            _mm256_and_si256(
+                _mm256_shuffle_epi8(firstHighTable, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), nibble)),
+                _mm256_shuffle_epi8(firstLowTable, _mm256_and_si256(previous1, nibble))
+            ),
+            _mm256_shuffle_epi8(secondHighTable, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble))
+        );
+
+        // Only leads 111_____ and 1111____ stay negative
+        auto third = _mm256_subs_epu8(previousBytes<2>(block, previous), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+        auto fourth = _mm256_subs_epu8(previousBytes<3>(block, previous), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+
+        auto mustBeContinuation = _mm256_and_si256(
+            _mm256_or_si256(third, fourth),
+            _mm256_set1_epi8(static_cast<char>(0x80))
+        );
+
+        return _mm256_xor_si256(mustBeContinuation, special);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t findAvx2(const char* data, std::size_t size, bool json)
+    {
+        // Calling of SSE kernel with dirty upper halves
+        // of registers is slow, so scalar loop is used
+        if (size < 32)
+        {
+            return findScalar(data, size, json);
+        }
+
+        const auto control = _mm256_set1_epi8(0x1F);
+        const auto del = _mm256_set1_epi8(0x7F);
+        const auto quote = _mm256_set1_epi8(json ? '"' : 0x7F);
+        const auto backslash = _mm256_set1_epi8(json ? '\\' : 0x7F);
+
+        // Sequence, that starts in last 3 bytes, is not finished
+        const auto incompleteLimits = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1)
+        );
+
+        // Non ASCII bytes are not special here, they are
+        // checked by UTF-8 validation
+        auto specialMask = [&](__m256i block) __attribute__((target("avx2")))
+        {
+            auto special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(block, control), block), _mm256_cmpeq_epi8(block, del)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash))
+            );
+
+            return static_cast<unsigned>(_mm256_movemask_epi8(special));
+        };
+
+        auto previous = _mm256_setzero_si256();
+        auto incomplete = false;
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= size; i += 32)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            auto mask = specialMask(block);
+
+            if (_mm256_movemask_epi8(block) == 0 && !incomplete)
+            {
+                if (mask != 0)
+                {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+
+                previous = block;
+                continue;
+            }
+
+            auto errors = utf8Errors(block, previous);
+
+            // Exact position is found by scalar code
+            // from beginning of broken sequence
+            if (mask != 0 || !_mm256_testz_si256(errors, errors))
+            {
+                break;
+            }
+
+            auto tail = _mm256_subs_epu8(block, incompleteLimits);
+
+            incomplete = !_mm256_testz_si256(tail, tail);
+            previous = block;
+        }
+
+        // Tail is checked with last block, that overlaps
+        // already checked bytes. Bytes of sequences, that
+        // are cut by block start, have to be in overlap
+        if (i < size && i + 32 > size && size - i <= 29)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + size - 32));
+            auto offset = 32 - (size - i);
+            auto mask = specialMask(block) >> offset;
+
+            if (_mm256_movemask_epi8(block) == 0 && !incomplete)
+            {
+                return mask != 0 ? i + static_cast<std::size_t>(__builtin_ctz(mask)) : size;
+            }
+
+            // Errors in overlap are false, there is
+            // no previous block
+            auto errors = _mm256_cmpeq_epi8(utf8Errors(block, _mm256_setzero_si256()), _mm256_setzero_si256());
+            auto errorsMask = ~static_cast<unsigned>(_mm256_movemask_epi8(errors)) >> offset;
+            auto tail = _mm256_subs_epu8(block, incompleteLimits);
+
+            if (mask == 0 && errorsMask == 0 && _mm256_testz_si256(tail, tail))
+            {
+                return size;
+            }
+        }
+
+        auto start = sequenceStart(data, i);
+
+        return start + findScalar(data + start, size - start, json);
+    }
+#endif
+
+    FindFunction bestKernel()
+    {
+#ifdef ALOGGER_AVX2
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return &findAvx2;
+        }
+#endif
+#ifdef ALOGGER_SSE2
+        return &findSse2;
+#else
+        return &findScalar;
+#endif
+    }
+
+    std::atomic<FindFunction> g_find(bestKernel());
+
+    /**
+     * @brief Function for getting length of valid
+     * UTF-8 sequence at the beginning of text.
+     * @return Sequence length or 0 if it's invalid.
+     */
+    std::size_t validSequenceLength(const unsigned char* data, std::size_t size)
+    {
+        auto first = data[0];
+
+        std::size_t length;
+        uint32_t minimum;
+        uint32_t codePoint;
+
+        if (first >= 0xC2 && first <= 0xDF)
+        {
+            length = 2;
+            minimum = 0x80;
+            codePoint = first & 0x1Fu;
+        }
+        else if (first >= 0xE0 && first <= 0xEF)
+        {
+            length = 3;
+            minimum = 0x800;
+            codePoint = first & 0x0Fu;
+        }
+        else if (first >= 0xF0 && first <= 0xF4)
+        {
+            length = 4;
+            minimum = 0x10000;
+            codePoint = first & 0x07u;
+        }
+        else
+        {
+            return 0;
+        }
+
+        if (size < length)
+        {
+            return 0;
+        }
+
+        for (std::size_t i = 1; i < length; ++i)
+        {
+            if ((data[i] & 0xC0u) != 0x80)
+            {
+                return 0;
+            }
+
+            codePoint = (codePoint << 6) | (data[i] & 0x3Fu);
+        }
+
+        // Overlong forms, surrogates and too big values
+        if (codePoint < minimum ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF) ||
+            codePoint > 0x10FFFF)
+        {
+            return 0;
+        }
+
+        return length;
+    }
+
+    void appendHex(std::string& result, const char* prefix, unsigned char symbol)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        result.append(prefix);
+        result.push_back(hex[symbol >> 4]);
+        result.push_back(hex[symbol & 0xF]);
+    }
+
+    void appendEscaped(std::string& result, unsigned char symbol, bool json)
+    {
+        switch (symbol)
+        {
+        case '\n':
+            result.append("\\n");
+            return;
+        case '\r':
+            result.append("\\r");
+            return;
+        case '\t':
+            // Tabulation does not break lines
+            if (json)
+            {
+                result.append("\\t");
+            }
+            else
+            {
+                result.push_back('\t');
+            }
+            return;
+        case '"':
+            result.append("\\\"");
+            return;
+        case '\\':
+            result.append("\\\\");
+            return;
+        default:
+            appendHex(result, json ? "\\u00" : "\\x", symbol);
+            return;
+        }
+    }
+}
+
+void Formatters::Sanitizer::append(std::string& result, std::string_view text, Formatters::Sanitizer::Mode mode)
+{
+    auto json = mode == Mode::Json;
+    auto find = g_find.load(std::memory_order_relaxed);
+
+    auto data = text.data();
+    auto size = text.size();
+
+    while (size > 0)
+    {
+        auto clean = find(data, size, json);
+
+        result.append(data, clean);
+
+        data += clean;
+        size -= clean;
+
+        // Non ASCII bytes and special symbols are
+        // processed one by one until next clean run
+        while (size > 0 && isSpecial(static_cast<unsigned char>(*data), json))
+        {
+            auto symbol = static_cast<unsigned char>(*data);
+
+            if (symbol < 0x80)
+            {
+                appendEscaped(result, symbol, json);
+
+                ++data;
+                --size;
+                continue;
+            }
+
+            auto length = validSequenceLength(reinterpret_cast<const unsigned char*>(data), size);
+
+            if (length != 0)
+            {
+                result.append(data, length);
+
+                data += length;
+                size -= length;
+                continue;
+            }
+
+            if (json)
+            {
+                result.append("\\ufffd");
+            }
+            else
+            {
+                appendHex(result, "\\x", symbol);
+            }
+
+            ++data;
+            --size;
+        }
+    }
+}
+
+std::size_t Formatters::Sanitizer::findSpecial(std::string_view text, Formatters::Sanitizer::Mode mode)
+{
+    return g_find.load(std::memory_order_relaxed)(text.data(), text.size(), mode == Mode::Json);
+}
+
+void Formatters::Sanitizer::setSimdEnabled(bool enabled)
+{
+    g_find = enabled ? bestKernel() : &findScalar;
+}
+
+const char* Formatters::Sanitizer::kernelName()
+{
+    auto find = g_find.load();
+
+#ifdef ALOGGER_AVX2
+    if (find == &findAvx2)
+    {
+        return "avx2";
+    }
+#endif
+#ifdef ALOGGER_SSE2
+    if (find == &findSse2)
+    {
+        return "sse2";
+    }
+#endif
+
+    return "scalar";
+}
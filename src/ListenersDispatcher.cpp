@@ -0,0 +1,197 @@
+#include <algorithm>
+#include "ListenersDispatcher.hpp"
+#include "BatchLogsListener.hpp"
+
+Logger::ListenersDispatcher::ListenersDispatcher(std::size_t capacity) :
+    m_ring(std::make_shared<MessagesRing>(capacity)),
+    m_subscriptions(),
+    m_listenersCount(0),
+    m_droppedMessages(0),
+    m_mutex(),
+    m_variable(),
+    m_sleeping(false),
+    m_working(true),
+    m_thread()
+{
+
+}
+
+Logger::ListenersDispatcher::~ListenersDispatcher()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_working = false;
+    }
+
+    m_variable.notify_all();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void Logger::ListenersDispatcher::addListener(LogsListenerPtr listener)
+{
+    // Batch listeners are reading ring by themselves
+    auto batchListener = std::dynamic_pointer_cast<BatchLogsListener>(listener);
+
+    if (batchListener)
+    {
+        batchListener->attach(m_ring);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_subscriptions.push_back(std::make_shared<Subscription>(
+        Subscription{std::move(listener), m_ring->head(), batchListener != nullptr}
+    ));
+
+    m_listenersCount = m_subscriptions.size();
+
+    if (!m_thread.joinable())
+    {
+        m_thread = std::thread(&Logger::ListenersDispatcher::dispatchingThread, this);
+    }
+}
+
+void Logger::ListenersDispatcher::removeListener(const LogsListenerPtr& listener)
+{
+    auto batchListener = std::dynamic_pointer_cast<BatchLogsListener>(listener);
+
+    if (batchListener)
+    {
+        batchListener->detach(m_ring);
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto finded = std::find_if(
+        m_subscriptions.begin(),
+        m_subscriptions.end(),
+        [&listener](const SubscriptionPtr& subscription)
+        {
+            return subscription->listener == listener;
+        }
+    );
+
+    if (finded == m_subscriptions.end())
+    {
+        return;
+    }
+
+    m_subscriptions.erase(finded);
+
+    m_listenersCount = m_subscriptions.size();
+}
+
+bool Logger::ListenersDispatcher::hasListeners() const
+{
+    return m_listenersCount.load(std::memory_order_acquire) != 0;
+}
+
+void Logger::ListenersDispatcher::publish(const AbstractLogger::Message& message)
+{
+    // Listeners get wall time only
+    m_ring->push(message);
+
+    // Mutex is taken only if dispatcher is idle,
+    // so wake up will not be lost
+    if (m_sleeping)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+
+        m_variable.notify_one();
+    }
+}
+
+uint64_t Logger::ListenersDispatcher::droppedMessages() const
+{
+    return m_droppedMessages;
+}
+
+void Logger::ListenersDispatcher::dispatchingThread()
+{
+    std::vector<SubscriptionPtr> subscriptions;
+    MessagesRing::MessagePtr message;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_working)
+    {
+        // Removing listeners if they have reference counter value 1
+        m_subscriptions.erase(
+            std::remove_if(
+                m_subscriptions.begin(),
+                m_subscriptions.end(),
+                [](const SubscriptionPtr& subscription)
+                {
+                    return subscription->listener.use_count() <= 1;
+                }
+            ),
+            m_subscriptions.end()
+        );
+
+        m_listenersCount = m_subscriptions.size();
+
+        subscriptions = m_subscriptions;
+
+        auto head = m_ring->head();
+
+        lock.unlock();
+
+        bool delivered = false;
+        uint64_t dropped = 0;
+
+        for (auto&& subscription : subscriptions)
+        {
+            if (subscription->pulling)
+            {
+                continue;
+            }
+
+            for (std::size_t i = 0;
+                 i < DispatchBatchSize &&
+                 m_ring->read(subscription->cursor, message, dropped);
+                 ++i)
+            {
+                subscription->listener->newMessage(*message);
+                delivered = true;
+            }
+        }
+
+        if (dropped != 0)
+        {
+            m_droppedMessages += dropped;
+        }
+
+        message.reset();
+        subscriptions.clear();
+
+        lock.lock();
+
+        if (delivered || !m_working)
+        {
+            continue;
+        }
+
+        m_sleeping = true;
+
+        // Message could be claimed, but not published yet.
+        // Timeout guarantees, that it will be dispatched.
+        if (m_ring->head() == head)
+        {
+            m_variable.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        else
+        {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+
+        m_sleeping = false;
+    }
+}
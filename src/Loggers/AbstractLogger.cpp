@@ -3,32 +3,60 @@
 #include <SystemTools.h>
 #include <cstdint>
 #include <algorithm>
-#include <map>
 #include "Loggers/AbstractLogger.hpp"
 #include <LogsListener.hpp>
+#include <ListenersDispatcher.hpp>
+#include <FlightRecorder.hpp>
+#include <Backtrace.hpp>
+#include <Categories.hpp>
+#include <Formatters/PatternFormatter.hpp>
+#include <Sinks/TerminalSink.hpp>
+#include <Sinks/FileSink.hpp>
+
+struct AbstractLogger::Configuration
+{
+    Formatters::FormatterPtr formatter;
+    std::shared_ptr<Sinks::TerminalSink> terminalSink;
+    std::shared_ptr<Sinks::FileSink> fileSink;
+    std::vector<Sinks::SinkPtr> sinks;
+};
 
 AbstractLogger::AbstractLogger() :
-    m_logsListeners(),
-    m_maxLogFileSizeBytes(static_cast<uint64_t>(2 * 1024 * 1024)),
-    m_formatString("%{DATETIME} %{FILENAME}:%{LINE} [%{THREAD}][%{CONTEXT}] %{ERROR_CLASS}: %{MESSAGE}"),
-    m_formatCache(),
-    m_fileLogPath("logs"),
+    m_listenersDispatcher(std::make_unique<Logger::ListenersDispatcher>()),
+    m_configuration(),
     m_sourceFilenameTruncationEnabled(false),
-    m_minTerminalOutputErrorClass(ErrorClass::Info),
-    m_minFileOutputErrorClass(ErrorClass::Info),
-    m_ss()
+    m_pins()
 {
-    cacheFormat();
+    auto terminalSink = std::make_shared<Sinks::TerminalSink>();
+    auto fileSink = std::make_shared<Sinks::FileSink>();
+
+    m_configuration.store({
+        std::make_shared<Formatters::PatternFormatter>(
+            "%{DATETIME} %{FILENAME}:%{LINE} [%{THREAD}][%{CONTEXT}] %{ERROR_CLASS}: %{MESSAGE}"
+        ),
+        terminalSink,
+        fileSink,
+        {terminalSink, fileSink}
+    });
+}
+
+AbstractLogger::~AbstractLogger()
+{
+    // Writing collapsed repeats, that are left
+    for (auto&& sink : sinks())
+    {
+        sink->flushRepeats();
+    }
 }
 
 void AbstractLogger::setMaximumLogFile(uint64_t bytes)
 {
-    m_maxLogFileSizeBytes = bytes;
+    fileSink()->setMaximumLogFile(bytes);
 }
 
 uint64_t AbstractLogger::maximumLogFile() const
 {
-    return m_maxLogFileSizeBytes;
+    return fileSink()->maximumLogFile();
 }
 
 std::string AbstractLogger::classPlusFunction(std::string classname, const char *function)
@@ -49,22 +77,45 @@ void AbstractLogger::log(AbstractLogger::ErrorClass errorClass,
                  std::thread::id thread,
                  std::string classname,
                  const char *function,
-                 std::string message)
+                 std::string message,
+                 Logger::Fields fields,
+                 uint64_t timestamp)
 {
     if (errorClass == ErrorClass::None)
     {
         return;
     }
 
+    if (Logger::FlightRecorder::isEnabled())
+    {
+        if (errorClass >= Logger::FlightRecorder::triggerLevel())
+        {
+            // History is written before message, that triggered it
+            triggerFlightRecorder();
+        }
+        else if (errorClass >= Logger::FlightRecorder::level() && !isAccepted(errorClass))
+        {
+            Logger::FlightRecorder::record(errorClass, filename, line, thread, classname, function, message);
+        }
+    }
+
     Message messageObject;
 
-    // Getting current time
-    messageObject.timePoint = std::chrono::system_clock::now();
+    // Conversion to wall time is deferred to formatting
+    messageObject.timestamp = timestamp != 0 ? timestamp : Logger::Clock::now();
     messageObject.errorClass = errorClass;
     messageObject.message = std::move(message);
     messageObject.thread = thread;
     messageObject.context = std::move(classPlusFunction(std::move(classname), function));
     messageObject.line = line;
+    messageObject.fields = std::move(fields);
+
+    // Only addresses are taken here, they
+    // are resolved by formatter
+    if (Logger::Backtrace::isCaptured(errorClass))
+    {
+        Logger::Backtrace::capture(messageObject.backtrace, 1);
+    }
 
     if (m_sourceFilenameTruncationEnabled)
     {
@@ -75,141 +126,243 @@ void AbstractLogger::log(AbstractLogger::ErrorClass errorClass,
         messageObject.filename = filename;
     }
 
-    // Removing data listeners if they have reference counter value 1
+    // Passing message to logs listeners
+    if (m_listenersDispatcher->hasListeners())
+    {
+        m_listenersDispatcher->publish(messageObject);
+    }
+
+    onNewMessage(messageObject);
+}
 
-    if (!m_logsListeners.empty())
+void AbstractLogger::logSpan(const char* filename,
+                             int line,
+                             std::thread::id thread,
+                             const char* function,
+                             std::string_view name,
+                             uint64_t begin,
+                             uint64_t duration)
+{
+    if (!acceptsSpans())
     {
-        m_logsListeners.erase(
-            std::remove_if(
-                m_logsListeners.begin(),
-                m_logsListeners.end(),
-                [](Logger::LogsListenerPtr ptr)
-                {
-                    return ptr.use_count() <= 1;
-                }
-            ),
-            m_logsListeners.end()
-        );
+        return;
     }
 
-    // Adding data to logs listener
-    for (auto&& listener : m_logsListeners)
+    Message messageObject;
+
+    messageObject.timestamp = begin;
+    messageObject.errorClass = ErrorClass::Debug;
+    messageObject.message.assign(name.data(), name.size());
+    messageObject.thread = thread;
+    messageObject.context = function;
+    messageObject.line = line;
+    messageObject.span = true;
+    messageObject.spanDuration = duration;
+
+    if (m_sourceFilenameTruncationEnabled)
     {
-        listener->newMessage(messageObject);
+        messageObject.filename = (strrchr(filename, '/') ? strrchr(filename, '/') + 1 : filename);
+    }
+    else
+    {
+        messageObject.filename = filename;
     }
 
     onNewMessage(messageObject);
 }
 
-std::string AbstractLogger::messageToString(const AbstractLogger::Message& message)
+bool AbstractLogger::acceptsSpans() const
 {
-    m_ss.str(std::string());
+    Epoch::ReadGuard guard;
 
-    for (auto&& cache : m_formatCache)
+    for (auto&& sink : m_configuration.load()->sinks)
     {
-        switch (cache.type)
-        {
-        case FormatCache::Type::DateTime:
+        if (sink->acceptsSpans())
         {
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                message.timePoint.time_since_epoch()
-            );
+            return true;
+        }
+    }
 
-            auto fractional_seconds = ms.count() % 1000;
+    return false;
+}
 
-            auto time = std::chrono::system_clock::to_time_t(message.timePoint);
-            std::tm* now = std::localtime(&time);
+std::string AbstractLogger::messageToString(const AbstractLogger::Message& message)
+{
+    Epoch::ReadGuard guard;
 
-            m_ss << (now->tm_year + 1900) << '-';
+    return m_configuration.load()->formatter->format(message);
+}
 
-            m_ss.width(2);
-            m_ss.fill('0');
-            m_ss << (now->tm_mon + 1)     << '-';
+Formatters::FormatterPtr AbstractLogger::sinkFormatter(const AbstractLogger::Configuration& configuration,
+                                                       const Sinks::SinkPtr& sink)
+{
+    auto formatter = sink->formatter();
 
-            m_ss.width(2);
-            m_ss.fill('0');
-            m_ss <<  now->tm_mday         << ' ';
+    if (formatter == nullptr)
+    {
+        return configuration.formatter;
+    }
 
-            m_ss.width(2);
-            m_ss.fill('0');
-            m_ss <<  now->tm_hour         << ':';
+    return formatter;
+}
 
-            m_ss.width(2);
-            m_ss.fill('0');
-            m_ss <<  now->tm_min          << ':';
+bool AbstractLogger::sinkAccepts(const Sinks::SinkPtr& sink, const AbstractLogger::Message& message)
+{
+    // Spans are written only by trace sinks
+    if (message.span)
+    {
+        return sink->acceptsSpans();
+    }
+
+    if (message.history)
+    {
+        return sink->accepts(Logger::FlightRecorder::triggerLevel());
+    }
 
-            m_ss.width(2);
-            m_ss.fill('0');
-            m_ss <<  now->tm_sec          << ',';
+    return sink->accepts(message.errorClass);
+}
+
+bool AbstractLogger::isAccepted(const AbstractLogger::Message& message) const
+{
+    Epoch::ReadGuard guard;
 
-            m_ss.width(3);
-            m_ss <<  fractional_seconds;
-            break;
+    for (auto&& sink : m_configuration.load()->sinks)
+    {
+        if (sinkAccepts(sink, message))
+        {
+            return true;
         }
-        case FormatCache::Type::FileName:
-            m_ss << message.filename;
-            break;
-        case FormatCache::Type::Line:
-            m_ss << message.line;
-            break;
-        case FormatCache::Type::Thread:
+    }
+
+    return false;
+}
+
+AbstractLogger::ErrorClass AbstractLogger::minimumAcceptedErrorClass() const
+{
+    auto result = minimumListenedErrorClass();
+
+    Epoch::ReadGuard guard;
+
+    for (auto&& sink : m_configuration.load()->sinks)
+    {
+        result = std::min(result, sink->minimumErrorClass());
+    }
+
+    return result;
+}
+
+AbstractLogger::ErrorClass AbstractLogger::minimumListenedErrorClass() const
+{
+    if (m_listenersDispatcher->hasListeners())
+    {
+        return ErrorClass::Unknown;
+    }
+
+    // Trigger message has to reach logger, even
+    // if sinks don't accept it
+    if (Logger::FlightRecorder::isEnabled())
+    {
+        return Logger::FlightRecorder::triggerLevel();
+    }
+
+    return ErrorClass::None;
+}
+
+bool AbstractLogger::isAccepted(AbstractLogger::ErrorClass errorClass) const
+{
+    Epoch::ReadGuard guard;
+
+    for (auto&& sink : m_configuration.load()->sinks)
+    {
+        if (sink->accepts(errorClass))
         {
-            m_ss << "0x";
-            auto old = m_ss.fill();
-            m_ss.fill('0');
-            auto oldWidth = m_ss.width();
-            m_ss.width(16);
-            m_ss << std::hex << message.thread << std::dec;
-            m_ss.fill(old);
-            m_ss.width(oldWidth);
-            break;
+            return true;
         }
-        case FormatCache::Type::Context:
-            m_ss << message.context;
-            break;
-        case FormatCache::Type::ErrorClass:
+    }
+
+    return false;
+}
+
+void AbstractLogger::formatMessage(const AbstractLogger::Message& message,
+                                   AbstractLogger::FormattedStrings& strings) const
+{
+    strings.clear();
+
+    Epoch::ReadGuard guard;
+
+    auto configuration = m_configuration.load();
+
+    for (auto&& sink : configuration->sinks)
+    {
+        if (!sinkAccepts(sink, message))
         {
-            switch (message.errorClass)
+            continue;
+        }
+
+        auto formatter = sinkFormatter(*configuration, sink);
+
+        auto found = std::find_if(
+            strings.begin(),
+            strings.end(),
+            [&formatter](const FormattedStrings::value_type& value)
             {
-            case ErrorClass::Unknown:
-                m_ss << "Unknown";
-                break;
-            case ErrorClass::Debug:
-                m_ss << "Debug";
-                break;
-            case ErrorClass::Info:
-                m_ss << "Info";
-                break;
-            case ErrorClass::Warning:
-                m_ss << "Warning";
-                break;
-            case ErrorClass::Error:
-                m_ss << "Error";
-                break;
-            case ErrorClass::None:
-                log(
-                    ErrorClass::Error,
-                    __FILENAME__,
-                    __LINE__,
-                    std::this_thread::get_id(),
-                    std::move(SystemTools::getTypeName(*this)),
-                    __FUNCTION__,
-                    "Message with error class 'None' detected. You shall not push 'None' messages."
-                );
-                return std::string();
+                return value.first->isEquivalent(*formatter);
             }
-            break;
+        );
+
+        if (found != strings.end())
+        {
+            continue;
         }
-        case FormatCache::Type::Message:
-            m_ss << message.message;
-            break;
-        case FormatCache::Type::String:
-            m_ss << cache.value;
-            break;
+
+        strings.emplace_back(formatter, formatter->format(message));
+    }
+}
+
+void AbstractLogger::writeMessage(const AbstractLogger::Message& message,
+                                  const AbstractLogger::FormattedStrings& strings)
+{
+    Epoch::ReadGuard guard;
+
+    auto configuration = m_configuration.load();
+
+    for (auto&& sink : configuration->sinks)
+    {
+        if (!sinkAccepts(sink, message))
+        {
+            continue;
         }
+
+        auto formatter = sinkFormatter(*configuration, sink);
+
+        auto found = std::find_if(
+            strings.begin(),
+            strings.end(),
+            [&formatter](const FormattedStrings::value_type& value)
+            {
+                return value.first->isEquivalent(*formatter);
+            }
+        );
+
+        // Sink configuration was changed after formatting
+        if (found == strings.end())
+        {
+            sink->write(message, formatter->format(message), formatter);
+            continue;
+        }
+
+        sink->write(message, found->second, formatter);
     }
+}
 
-    return m_ss.str();
+void AbstractLogger::commitSinks()
+{
+    Epoch::ReadGuard guard;
+
+    for (auto&& sink : m_configuration.load()->sinks)
+    {
+        sink->commit();
+    }
 }
 
 void AbstractLogger::setFilenameTruncationEnabled(bool truncate)
@@ -224,176 +377,220 @@ bool AbstractLogger::filenameTruncationEnabled() const
 
 void AbstractLogger::setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass errorClass)
 {
-    m_minTerminalOutputErrorClass = errorClass;
+    terminalSink()->setMinimumErrorClass(errorClass);
 }
 
 AbstractLogger::ErrorClass AbstractLogger::minimumTerminalOutputErrorClass() const
 {
-    return m_minTerminalOutputErrorClass;
+    return terminalSink()->minimumErrorClass();
 }
 
 void AbstractLogger::setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass errorClass)
 {
-    m_minFileOutputErrorClass = errorClass;
+    fileSink()->setMinimumErrorClass(errorClass);
 }
 
 AbstractLogger::ErrorClass AbstractLogger::minimumFileOutputErrorClass() const
 {
-    return m_minFileOutputErrorClass;
+    return fileSink()->minimumErrorClass();
 }
 
 void AbstractLogger::setLogPath(std::string path)
 {
-    m_fileLogPath = std::move(path);
+    fileSink()->setLogPath(std::move(path));
 }
 
 std::string AbstractLogger::logPath() const
 {
-    return m_fileLogPath;
+    return fileSink()->logPath();
 }
 
 void AbstractLogger::setFormat(std::string format)
 {
-    m_formatString = std::move(format);
-
-    cacheFormat();
+    setFormatter(std::make_shared<Formatters::PatternFormatter>(std::move(format)));
 }
 
 std::string AbstractLogger::format() const
 {
-    return m_formatString;
-}
+    auto formatter = this->formatter();
 
-std::string AbstractLogger::getLogPath() const
-{
-    // Opening current file
-    std::string filename = "log.txt";
+    auto patternFormatter = dynamic_cast<const Formatters::PatternFormatter*>(formatter.get());
 
-    if (m_maxLogFileSizeBytes == 0)
+    if (patternFormatter == nullptr)
     {
-        return filename;
+        return std::string();
     }
 
-    std::string path = SystemTools::Path::join(m_fileLogPath, filename);
-
-    auto filesize = static_cast<uint64_t>(SystemTools::Path::getFileSize(path));
+    return patternFormatter->pattern();
+}
 
-    if (filesize > m_maxLogFileSizeBytes)
-    {
-        uint64_t i;
-        // Renaming to new one
-        for (i = 0;
-             i < std::numeric_limits<uint64_t>::max() &&
-             SystemTools::Path::fileExists(path + "_" + std::to_string(i + 1));
-             ++i)
-        {}
-
-        // Ok, we received end
-        if (i == std::numeric_limits<int>::max())
+void AbstractLogger::setFormatter(Formatters::FormatterPtr formatter)
+{
+    m_configuration.update(
+        [&formatter](Configuration& configuration)
         {
-            // Notify that everything is fucked up, duh
-            return "";
+            configuration.formatter = std::move(formatter);
         }
+    );
+}
 
-        std::rename(path.c_str(), (path + "_" + std::to_string(i + 1)).c_str());
-    }
+Formatters::FormatterPtr AbstractLogger::formatter() const
+{
+    Epoch::ReadGuard guard;
 
-    return path;
+    return m_configuration.load()->formatter;
 }
 
-void AbstractLogger::addLogsListener(Logger::LogsListenerPtr listener)
+void AbstractLogger::addSink(Sinks::SinkPtr sink)
 {
-    m_logsListeners.push_back(listener);
+    m_configuration.update(
+        [&sink](Configuration& configuration)
+        {
+            configuration.sinks.push_back(std::move(sink));
+        }
+    );
+
+    Logger::Categories::invalidate();
 }
 
-void AbstractLogger::removeLogsListener(Logger::LogsListenerPtr listener)
+void AbstractLogger::removeSink(const Sinks::SinkPtr& sink)
 {
-    auto finded = std::find(
-            m_logsListeners.begin(),
-            m_logsListeners.end(),
-            listener
-    );
+    m_configuration.update(
+        [&sink](Configuration& configuration)
+        {
+            auto finded = std::find(
+                configuration.sinks.begin(),
+                configuration.sinks.end(),
+                sink
+            );
 
-    if (finded == m_logsListeners.end())
-    {
-        return;
-    }
+            if (finded != configuration.sinks.end())
+            {
+                configuration.sinks.erase(finded);
+            }
+        }
+    );
 
-    m_logsListeners.erase(finded);
+    Logger::Categories::invalidate();
 }
 
-void AbstractLogger::waitForLogToBeWritten()
+std::vector<Sinks::SinkPtr> AbstractLogger::sinks() const
 {
+    Epoch::ReadGuard guard;
 
+    return m_configuration.load()->sinks;
 }
 
-void AbstractLogger::cacheFormat()
+std::shared_ptr<Sinks::TerminalSink> AbstractLogger::terminalSink() const
 {
+    Epoch::ReadGuard guard;
 
-    const std::map<std::string_view, FormatCache::Type> variables = {
-        {"%{DATETIME}",    FormatCache::Type::DateTime  },
-        {"%{FILENAME}",    FormatCache::Type::FileName  },
-        {"%{LINE}",        FormatCache::Type::Line      },
-        {"%{CONTEXT}",     FormatCache::Type::Context   },
-        {"%{ERROR_CLASS}", FormatCache::Type::ErrorClass},
-        {"%{MESSAGE}",     FormatCache::Type::Message   },
-        {"%{THREAD}",      FormatCache::Type::Thread    },
-    };
-
-    m_formatCache.clear();
+    return m_configuration.load()->terminalSink;
+}
 
-    std::string::size_type index = 0;
-    std::string::size_type endIndex = 0;
-    std::string::size_type previousString = 0;
-    auto mapIterator = variables.end();
+std::shared_ptr<Sinks::FileSink> AbstractLogger::fileSink() const
+{
+    Epoch::ReadGuard guard;
 
-    while (index < m_formatString.size())
-    {
-        // Searching for `%{` symbol
-        index = m_formatString.find("%{", index);
+    return m_configuration.load()->fileSink;
+}
 
-        // If was not found, string is finished.
-        if (index == std::string::npos)
+void AbstractLogger::setFileSink(std::shared_ptr<Sinks::FileSink> sink)
+{
+    m_configuration.update(
+        [&sink](Configuration& configuration)
         {
-            m_formatCache.emplace_back(
-                FormatCache::Type::String,
-                std::string_view(m_formatString.c_str() + previousString, m_formatString.size() - previousString)
+            auto& fileSink = configuration.fileSink;
+
+            sink->setLogPath(fileSink->logPath());
+            sink->setMaximumLogFile(fileSink->maximumLogFile());
+            sink->setMinimumErrorClass(fileSink->minimumErrorClass());
+            sink->setFormatter(fileSink->formatter());
+
+            std::replace(
+                configuration.sinks.begin(),
+                configuration.sinks.end(),
+                Sinks::SinkPtr(fileSink),
+                Sinks::SinkPtr(sink)
             );
 
-            break;
+            fileSink = std::move(sink);
         }
+    );
 
-        // Searching for close symbol
-        endIndex = m_formatString.find('}', index);
+    Logger::Categories::invalidate();
+}
 
-        // Searching for founded expected variable
-        std::string_view subString(m_formatString.c_str() + index, (endIndex + 1) - index);
+void AbstractLogger::addLogsListener(Logger::LogsListenerPtr listener)
+{
+    m_listenersDispatcher->addListener(std::move(listener));
 
-        mapIterator = variables.find(subString);
+    // Listeners receive messages of all levels
+    Logger::Categories::invalidate();
+}
 
-        // If it's not variable
-        if (mapIterator == variables.end())
-        {
-            index += 1;
-            continue;
-        }
+void AbstractLogger::removeLogsListener(Logger::LogsListenerPtr listener)
+{
+    m_listenersDispatcher->removeListener(listener);
+
+    Logger::Categories::invalidate();
+}
+
+void AbstractLogger::triggerFlightRecorder()
+{
+    std::vector<Message> history;
+
+    Logger::FlightRecorder::takeHistory(history);
 
-        // If it's variable, pushing string before,
-        // if it's not empty. Pushing variable
-        if (previousString < index)
+    if (history.empty())
+    {
+        return;
+    }
+
+    Message header;
+
+    header.timePoint = std::chrono::system_clock::now();
+    header.errorClass = ErrorClass::Info;
+    header.message = "Flight recorder history, " + std::to_string(history.size()) + " messages";
+    header.thread = std::this_thread::get_id();
+    header.filename = "ALogger";
+    header.context = "FlightRecorder";
+    header.history = true;
+
+    onNewMessage(header);
+
+    for (auto&& message : history)
+    {
+        if (m_sourceFilenameTruncationEnabled)
         {
-            m_formatCache.emplace_back(
-                    FormatCache::Type::String,
-                    std::string_view(m_formatString.c_str() + previousString, index - previousString)
-            );
+            message.filename = (strrchr(message.filename, '/') ? strrchr(message.filename, '/') + 1 : message.filename);
         }
 
-        // Pushing variable and moving iterators
-        m_formatCache.emplace_back(
-                mapIterator->second
-        );
+        onNewMessage(message);
+    }
+}
 
-        previousString = endIndex + 1; // size of '}' = 1
-        index = endIndex + 1;
+void AbstractLogger::waitForLogToBeWritten()
+{
+    // Sinks are copied, so waiting does not block reconfiguration
+    for (auto&& sink : sinks())
+    {
+        sink->flushRepeats();
+
+        sink->waitForWritten();
+    }
+}
+
+bool AbstractLogger::waitForLogToBeDurable()
+{
+    waitForLogToBeWritten();
+
+    bool durable = true;
+
+    for (auto&& sink : sinks())
+    {
+        durable = sink->sync() && durable;
     }
+
+    return durable;
 }
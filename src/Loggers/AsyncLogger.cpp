@@ -1,136 +1,593 @@
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <mutex>
+#include <SystemTools.h>
 #include "Loggers/AsyncLogger.hpp"
+#include "Clock.hpp"
 
-Loggers::AsyncLogger::AsyncLogger() :
+#ifdef OS_LINUX
+    #include <csignal>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#ifdef OS_LINUX
+namespace
+{
+    const int CrashSignals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+
+    constexpr std::size_t CrashSignalsCount = sizeof(CrashSignals) / sizeof(CrashSignals[0]);
+
+    std::atomic<Loggers::AsyncLogger*> g_crashLogger(nullptr);
+    struct sigaction g_previousActions[CrashSignalsCount];
+    char g_crashLogPath[4096];
+
+    // Clock calibration for handler. It's double buffered,
+    // so handler never reads half written copy
+    Logger::Clock::Snapshot g_clockSnapshots[2];
+    std::atomic<int> g_clockSnapshot(0);
+    std::mutex g_clockSnapshotMutex;
+
+    void updateClockSnapshot()
+    {
+        std::unique_lock<std::mutex> lock(g_clockSnapshotMutex);
+
+        auto snapshot = Logger::Clock::snapshot();
+        auto index = g_clockSnapshot.load(std::memory_order_relaxed);
+
+        if (g_clockSnapshots[index].baseTicks == snapshot.baseTicks &&
+            g_clockSnapshots[index].nanosecondsPerTick == snapshot.nanosecondsPerTick)
+        {
+            return;
+        }
+
+        g_clockSnapshots[1 - index] = snapshot;
+        g_clockSnapshot.store(1 - index, std::memory_order_release);
+    }
+
+    void restoreSignalActions()
+    {
+        for (std::size_t i = 0; i < CrashSignalsCount; ++i)
+        {
+            sigaction(CrashSignals[i], &g_previousActions[i], nullptr);
+        }
+    }
+
+    // Functions below are async signal safe
+
+    void writeAll(const int* fds, std::size_t count, const char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (fds[i] < 0)
+            {
+                continue;
+            }
+
+            std::size_t written = 0;
+
+            while (written < size)
+            {
+                auto result = ::write(fds[i], data + written, size - written);
+
+                if (result <= 0)
+                {
+                    break;
+                }
+
+                written += static_cast<std::size_t>(result);
+            }
+        }
+    }
+
+    void writeString(const int* fds, std::size_t count, const char* string)
+    {
+        writeAll(fds, count, string, strlen(string));
+    }
+
+    void writeNumber(const int* fds, std::size_t count, uint64_t value, std::size_t width = 0)
+    {
+        char buffer[24];
+        std::size_t position = sizeof(buffer);
+
+        do
+        {
+            buffer[--position] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0 && position > 0);
+
+        while (sizeof(buffer) - position < width && position > 0)
+        {
+            buffer[--position] = '0';
+        }
+
+        writeAll(fds, count, buffer + position, sizeof(buffer) - position);
+    }
+}
+#endif
+
+Loggers::AsyncLogger::AsyncLogger(std::size_t formattingThreads, std::size_t queueCapacity) :
     m_working(true),
     m_mainThread(),
-    m_messages(),
+    m_formattingThreads(),
+    m_formattingThreadsCount(formattingThreads),
+    m_messages(queueCapacity),
     m_messagesMutex(),
+    m_sleepingThreads(0),
+    m_writtenSequence(0),
+    m_reorderBuffer(),
+    m_reorderMutex(),
+    m_reorderVariable(),
+    m_reorderSpaceVariable(),
     m_cond(),
     m_clearVariable()
 {
-    m_mainThread = std::thread(&Loggers::AsyncLogger::mainThread, this);
+    if (formattingThreads == 0)
+    {
+        m_mainThread = std::thread(&Loggers::AsyncLogger::mainThread, this);
+        return;
+    }
+
+    m_mainThread = std::thread(&Loggers::AsyncLogger::writerThread, this);
+
+    for (std::size_t i = 0; i < formattingThreads; ++i)
+    {
+        m_formattingThreads.emplace_back(&Loggers::AsyncLogger::formattingThread, this);
+    }
 }
 
 Loggers::AsyncLogger::~AsyncLogger()
 {
-    // Waiting until queue will be empty.
-    while (true)
+    if (crashHandlerEnabled())
+    {
+        setCrashHandlerEnabled(false);
+    }
+
+    // Waiting until everything will be written.
+    waitForLogToBeWritten();
+
+    {
+        std::scoped_lock<std::mutex, std::mutex> lock(m_messagesMutex, m_reorderMutex);
+        m_working = false;
+    }
+
+    m_cond.notify_all();
+    m_reorderVariable.notify_all();
+    m_reorderSpaceVariable.notify_all();
+
+    for (auto&& thread : m_formattingThreads)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (thread.joinable())
         {
-            std::unique_lock<std::mutex> lock(m_messagesMutex);
-            if (m_messages.empty())
+            thread.join();
+        }
+    }
+
+    if (m_mainThread.joinable())
+    {
+        m_mainThread.join();
+    }
+}
+
+std::size_t Loggers::AsyncLogger::formattingThreads() const
+{
+    return m_formattingThreadsCount;
+}
+
+void Loggers::AsyncLogger::setCrashHandlerEnabled(bool enabled)
+{
+#ifdef OS_LINUX
+    if (!enabled)
+    {
+        auto expected = this;
+
+        if (g_crashLogger.compare_exchange_strong(expected, nullptr))
+        {
+            restoreSignalActions();
+        }
+
+        return;
+    }
+
+    // Path is prepared, because handler can't allocate
+    auto path = SystemTools::Path::join(logPath(), "log.txt");
+
+    if (path.size() >= sizeof(g_crashLogPath))
+    {
+        throw std::runtime_error("Log path is too long for crash handler.");
+    }
+
+    Loggers::AsyncLogger* expected = nullptr;
+
+    if (!g_crashLogger.compare_exchange_strong(expected, this) && expected != this)
+    {
+        throw std::runtime_error("Crash handler is already enabled by other logger.");
+    }
+
+    // Handler can't touch clock state, calibration
+    // is copied here and by writer thread
+    updateClockSnapshot();
+
+    memcpy(g_crashLogPath, path.c_str(), path.size() + 1);
+
+    if (expected == this)
+    {
+        return;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = &Loggers::AsyncLogger::crashHandler;
+    sigemptyset(&action.sa_mask);
+
+    for (std::size_t i = 0; i < CrashSignalsCount; ++i)
+    {
+        sigaction(CrashSignals[i], &action, &g_previousActions[i]);
+    }
+#else
+    if (enabled)
+    {
+        throw std::runtime_error("Crash handler is available only on Linux.");
+    }
+#endif
+}
+
+bool Loggers::AsyncLogger::crashHandlerEnabled() const
+{
+#ifdef OS_LINUX
+    return g_crashLogger.load() == this;
+#else
+    return false;
+#endif
+}
+
+void Loggers::AsyncLogger::crashHandler(int signal)
+{
+#ifdef OS_LINUX
+    auto logger = g_crashLogger.exchange(nullptr);
+
+    if (logger != nullptr)
+    {
+        int fds[2] = {
+            ::open(g_crashLogPath, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644),
+            STDERR_FILENO
+        };
+
+        logger->emergencyFlush(fds, 2, signal);
+
+        if (fds[0] >= 0)
+        {
+            ::close(fds[0]);
+        }
+
+        restoreSignalActions();
+    }
+
+    // Signal is blocked inside handler, so it will
+    // be delivered with previous action after return
+    raise(signal);
+#else
+    (void) signal;
+#endif
+}
+
+void Loggers::AsyncLogger::emergencyFlush(const int* fds, std::size_t count, int signal) const
+{
+#ifdef OS_LINUX
+    static const char* errorClasses[] = {
+        "Unknown", "Debug", "Info", "Warning", "Error", "None"
+    };
+
+    uint64_t flushed = 0;
+
+    // Snapshot is used, because clock
+    // conversion isn't async signal safe
+    auto& clock = g_clockSnapshots[g_clockSnapshot.load(std::memory_order_acquire)];
+
+    m_messages.visit(
+        [fds, count, &flushed, &clock](const Logger::RecordQueue::View& view)
+        {
+            auto& message = view.header();
+
+            auto milliseconds = Logger::Clock::toNanoseconds(message.timestamp, clock) / 1000000;
+
+            auto writeText = [fds, count](const char* data, std::size_t size)
             {
-                break;
+                writeAll(fds, count, data, size);
+            };
+
+            writeNumber(fds, count, static_cast<uint64_t>(milliseconds / 1000));
+            writeString(fds, count, ".");
+            writeNumber(fds, count, static_cast<uint64_t>(milliseconds % 1000), 3);
+            writeString(fds, count, " ");
+
+            if (message.filename != nullptr)
+            {
+                writeString(fds, count, message.filename);
             }
+
+            writeString(fds, count, ":");
+            writeNumber(fds, count, static_cast<uint64_t>(std::max(message.line, 0)));
+            writeString(fds, count, " [");
+            view.context(writeText);
+            writeString(fds, count, "] ");
+            writeString(fds, count, errorClasses[static_cast<int>(message.errorClass)]);
+            writeString(fds, count, ": ");
+            view.message(writeText);
+            writeString(fds, count, "\n");
+
+            ++flushed;
         }
-    }
+    );
 
-    m_working = false;
+    writeString(fds, count, "--- ALogger: ");
+    writeNumber(fds, count, flushed);
+    writeString(fds, count, " queued messages flushed on signal ");
+    writeNumber(fds, count, static_cast<uint64_t>(signal));
+    writeString(fds, count, " ---\n");
+#else
+    (void) fds;
+    (void) count;
+    (void) signal;
+#endif
+}
 
-    m_cond.notify_one();
+void Loggers::AsyncLogger::waitForMessages()
+{
+    std::unique_lock<std::mutex> lock(m_messagesMutex);
 
-    if (m_mainThread.joinable())
+    ++m_sleepingThreads;
+
+    // Pairs with fence in `onNewMessage`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_messages.empty() && m_working)
     {
-        m_mainThread.join();
+        m_cond.wait_for(lock, std::chrono::milliseconds(100));
     }
+
+    --m_sleepingThreads;
 }
 
 void Loggers::AsyncLogger::mainThread()
 {
-    while (m_working)
+    Message message = Message();
+    FormattedStrings strings;
+    uint64_t position;
+    uint64_t blocks;
+
+    while (true)
     {
-        // Locking queue
+#ifdef OS_LINUX
+        // Keeping calibration of crash handler fresh
+        if (g_crashLogger.load(std::memory_order_relaxed) == this)
         {
-            std::unique_lock<std::mutex> lock(m_messagesMutex);
+            updateClockSnapshot();
+        }
+#endif
+
+        uint64_t written = m_writtenSequence;
+
+        while (m_messages.tryPop(message, position, blocks))
+        {
+            formatMessage(message, strings);
+            writeMessage(message, strings);
+
+            written = position + blocks;
+        }
+
+        if (written != m_writtenSequence)
+        {
+            commitSinks();
 
-            while (m_messages.empty() && m_working)
             {
-                m_cond.wait(lock);
+                std::unique_lock<std::mutex> lock(m_messagesMutex);
+                m_writtenSequence = written;
             }
+
+            m_clearVariable.notify_all();
+            continue;
         }
-        // Unlocking queue
 
-        Message message = Message();
+        if (!m_working)
+        {
+            break;
+        }
 
-        // Locking queue
+        waitForMessages();
+    }
+}
+
+void Loggers::AsyncLogger::formattingThread()
+{
+    std::vector<FormattedMessage> formatted;
+    Message message;
+    uint64_t position;
+    uint64_t blocks;
+
+    // Passing formatted run of consecutive messages to writer
+    auto passRun = [this, &formatted](uint64_t sequence)
+    {
         {
-            std::ofstream file;
+            std::unique_lock<std::mutex> lock(m_reorderMutex);
+            m_reorderBuffer.emplace(sequence, std::move(formatted));
+        }
 
-            std::unique_lock<std::mutex> lock(m_messagesMutex);
-            while (!m_messages.empty())
+        formatted = std::vector<FormattedMessage>();
+
+        m_reorderVariable.notify_one();
+    };
+
+    while (true)
+    {
+        // Messages are not taken from queue, while
+        // writer is behind, so queue stays bounded
+        {
+            std::unique_lock<std::mutex> lock(m_reorderMutex);
+
+            while (m_working &&
+                   m_reorderBuffer.size() >= m_formattingThreadsCount * ReorderedBatchesPerThread)
             {
-                message = m_messages.front();
-                m_messages.pop();
+                m_reorderSpaceVariable.wait(lock);
+            }
+        }
 
-                lock.unlock();
+        // Spreading messages between formatting threads
+        auto batchSize = std::clamp<std::size_t>(
+            (m_messages.size() + m_formattingThreadsCount - 1) / m_formattingThreadsCount,
+            1,
+            FormattingBatchSize
+        );
 
-                auto stringRepresentation = messageToString(message);
+        uint64_t sequence = 0;
+        uint64_t next = 0;
+        std::size_t taken = 0;
 
-                if (message.errorClass >= minimumFileOutputErrorClass())
-                {
-                    if (!file.is_open())
-                    {
-                        file.open(getLogPath(), std::ios_base::out | std::ios_base::app);
-                    }
-
-                    if (file.is_open())
-                    {
-                        file << stringRepresentation << std::endl;
-                    }
-                }
+        for (; taken < batchSize && m_messages.tryPop(message, position, blocks); ++taken)
+        {
+            // Other threads could take messages between
+            if (!formatted.empty() && position != next)
+            {
+                passRun(sequence);
+            }
+
+            if (formatted.empty())
+            {
+                sequence = position;
+            }
 
-                if (message.errorClass >= minimumTerminalOutputErrorClass())
+            next = position + blocks;
+
+            formatted.push_back({std::move(message), FormattedStrings(), blocks});
+            formatMessage(formatted.back().message, formatted.back().strings);
+        }
+
+        if (!formatted.empty())
+        {
+            passRun(sequence);
+        }
+
+        if (taken != 0)
+        {
+            continue;
+        }
+
+        if (!m_working)
+        {
+            break;
+        }
+
+        waitForMessages();
+    }
+}
+
+void Loggers::AsyncLogger::writerThread()
+{
+    std::vector<std::vector<FormattedMessage>> batches;
+
+    while (true)
+    {
+        // Taking batches, that are next in order
+        {
+            std::unique_lock<std::mutex> lock(m_reorderMutex);
+
+            while (m_working &&
+                   (m_reorderBuffer.empty() ||
+                    m_reorderBuffer.begin()->first != m_writtenSequence))
+            {
+                m_reorderVariable.wait(lock);
+            }
+
+            if (!m_working)
+            {
+                break;
+            }
+
+            auto expectedSequence = m_writtenSequence.load();
+
+            for (auto iterator = m_reorderBuffer.begin();
+                 iterator != m_reorderBuffer.end() && iterator->first == expectedSequence;
+                 iterator = m_reorderBuffer.erase(iterator))
+            {
+                for (auto&& formatted : iterator->second)
                 {
-                    if (message.errorClass <= ErrorClass::Info)
-                    {
-                        std::cout << stringRepresentation << std::endl;
-                    }
-                    else
-                    {
-                        std::cerr << stringRepresentation << std::endl;
-                    }
+                    expectedSequence += formatted.blocks;
                 }
 
-                lock.lock();
+                batches.push_back(std::move(iterator->second));
             }
+        }
+
+        m_reorderSpaceVariable.notify_all();
 
-            lock.unlock();
+        uint64_t written = 0;
 
-            if (file.is_open())
+        for (auto&& batch : batches)
+        {
+            for (auto&& formatted : batch)
             {
-                file.close();
+                writeMessage(formatted.message, formatted.strings);
+
+                written += formatted.blocks;
             }
+        }
 
-            m_clearVariable.notify_all();
+        commitSinks();
+
+        batches.clear();
+
+        {
+            std::unique_lock<std::mutex> lock(m_messagesMutex);
+            m_writtenSequence += written;
         }
-        // Unlocking queue
+
+        m_clearVariable.notify_all();
     }
 }
 
 void Loggers::AsyncLogger::waitForLogToBeWritten()
 {
-    std::unique_lock<std::mutex> lock(m_messagesMutex);
+    // Messages, that are pushed before this call
+    auto pushed = m_messages.pushPosition();
 
-    if (m_messages.empty())
-    {
-        return;
-    }
+    std::unique_lock<std::mutex> lock(m_messagesMutex);
 
-    while (!m_messages.empty())
+    while (m_writtenSequence < pushed)
     {
         m_clearVariable.wait(lock);
     }
+
+    lock.unlock();
+
+    // Waiting for sinks with dedicated queues
+    AbstractLogger::waitForLogToBeWritten();
 }
 
 void Loggers::AsyncLogger::onNewMessage(const AbstractLogger::Message& message)
 {
+    if (!isAccepted(message))
+    {
+        return;
+    }
+
+    // Waiting for writer, if queue is full
+    while (!m_messages.tryPush(message))
     {
         std::unique_lock<std::mutex> lock(m_messagesMutex);
-        m_messages.push(message);
+
+        m_cond.notify_all();
+        m_clearVariable.wait_for(lock, std::chrono::milliseconds(1));
     }
 
-    m_cond.notify_one();
+    // Pairs with fence in `waitForMessages`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_sleepingThreads.load() != 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_messagesMutex);
+        }
+
+        m_cond.notify_one();
+    }
 }
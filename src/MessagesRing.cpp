@@ -0,0 +1,124 @@
+#include <thread>
+#include "MessagesRing.hpp"
+
+static void lockSlot(std::atomic_flag& lock)
+{
+    // Slot is locked only for pointer copy
+    while (lock.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+Logger::MessagesRing::MessagesRing(std::size_t capacity) :
+    m_slots(),
+    m_capacity(1),
+    m_head(0)
+{
+    while (m_capacity < capacity)
+    {
+        m_capacity <<= 1;
+    }
+
+    m_slots = std::make_unique<Slot[]>(m_capacity);
+
+    for (uint64_t i = 0; i < m_capacity; ++i)
+    {
+        m_slots[i].message = std::make_shared<AbstractLogger::Message>();
+    }
+}
+
+void Logger::MessagesRing::push(const AbstractLogger::Message& message)
+{
+    auto time = message.time();
+
+    std::shared_ptr<AbstractLogger::Message> released;
+
+    auto sequence = m_head.fetch_add(1);
+
+    auto& slot = m_slots[sequence & (m_capacity - 1)];
+
+    lockSlot(slot.lock);
+
+    // Other writer could lap this one
+    if (slot.sequence < sequence + 1)
+    {
+        // Reader can't take new reference under lock,
+        // so object, that isn't borrowed, is reused
+        if (slot.message.use_count() == 1)
+        {
+            // Pairs with release of last reader reference
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            *slot.message = message;
+        }
+        else
+        {
+            released = std::move(slot.message);
+            slot.message = std::make_shared<AbstractLogger::Message>(message);
+        }
+
+        slot.message->timePoint = time;
+        slot.message->timestamp = 0;
+        slot.sequence = sequence + 1;
+    }
+
+    slot.lock.clear(std::memory_order_release);
+
+    // Borrowed message is released outside of lock
+}
+
+uint64_t Logger::MessagesRing::head() const
+{
+    return m_head.load();
+}
+
+bool Logger::MessagesRing::read(uint64_t& cursor, MessagePtr& message, uint64_t& dropped) const
+{
+    return find(cursor, &message, dropped);
+}
+
+bool Logger::MessagesRing::canRead(uint64_t cursor) const
+{
+    uint64_t dropped = 0;
+
+    return find(cursor, nullptr, dropped);
+}
+
+bool Logger::MessagesRing::find(uint64_t& cursor, MessagePtr* message, uint64_t& dropped) const
+{
+    while (true)
+    {
+        auto& slot = m_slots[cursor & (m_capacity - 1)];
+
+        lockSlot(slot.lock);
+
+        auto sequence = slot.sequence;
+
+        if (sequence == cursor + 1 && message != nullptr)
+        {
+            *message = slot.message;
+        }
+
+        slot.lock.clear(std::memory_order_release);
+
+        if (sequence == cursor + 1)
+        {
+            ++cursor;
+            return true;
+        }
+
+        // Message is not written yet
+        if (sequence < cursor + 1)
+        {
+            return false;
+        }
+
+        // Message was overwritten, skipping to oldest one
+        auto head = m_head.load();
+        auto oldest = std::max(cursor + 1, head > m_capacity ? head - m_capacity : 0);
+
+        dropped += oldest - cursor;
+        cursor = oldest;
+    }
+}
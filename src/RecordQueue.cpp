@@ -0,0 +1,444 @@
+#include <algorithm>
+#include <cstring>
+#include "RecordQueue.hpp"
+
+namespace
+{
+    std::size_t fieldsSize(const Logger::Fields& fields)
+    {
+        std::size_t size = 0;
+
+        for (auto&& field : fields)
+        {
+            size += 1 + sizeof(uint32_t) + field.key.size();
+
+            if (field.type == Logger::Field::Type::String)
+            {
+                size += sizeof(uint32_t) + field.string.size();
+            }
+            else
+            {
+                size += sizeof(uint64_t);
+            }
+        }
+
+        return size;
+    }
+
+    void appendBytes(std::string& result, const void* data, std::size_t size)
+    {
+        result.append(static_cast<const char*>(data), size);
+    }
+
+    void appendString(std::string& result, const std::string& string)
+    {
+        auto size = static_cast<uint32_t>(string.size());
+
+        appendBytes(result, &size, sizeof(size));
+        result.append(string);
+    }
+
+    /**
+     * @brief Fields are packed as type, key and
+     * raw value or string.
+     */
+    void packFields(std::string& result, const Logger::Fields& fields)
+    {
+        for (auto&& field : fields)
+        {
+            result.push_back(static_cast<char>(field.type));
+
+            appendString(result, field.key);
+
+            switch (field.type)
+            {
+            case Logger::Field::Type::String:
+                appendString(result, field.string);
+                break;
+            case Logger::Field::Type::Bool:
+            {
+                uint64_t value = field.boolValue ? 1 : 0;
+                appendBytes(result, &value, sizeof(value));
+                break;
+            }
+            default:
+                appendBytes(result, &field.uintValue, sizeof(field.uintValue));
+                break;
+            }
+        }
+    }
+
+    bool readString(const std::string& data, std::size_t& offset, std::string& string)
+    {
+        uint32_t size = 0;
+
+        if (offset + sizeof(size) > data.size())
+        {
+            return false;
+        }
+
+        std::memcpy(&size, data.data() + offset, sizeof(size));
+        offset += sizeof(size);
+
+        if (offset + size > data.size())
+        {
+            return false;
+        }
+
+        string.assign(data, offset, size);
+        offset += size;
+
+        return true;
+    }
+
+    void unpackFields(const std::string& data, Logger::Fields& fields)
+    {
+        fields.clear();
+
+        std::size_t offset = 0;
+
+        while (offset < data.size())
+        {
+            Logger::Field field;
+            field.type = static_cast<Logger::Field::Type>(data[offset++]);
+
+            if (!readString(data, offset, field.key))
+            {
+                return;
+            }
+
+            if (field.type == Logger::Field::Type::String)
+            {
+                if (!readString(data, offset, field.string))
+                {
+                    return;
+                }
+            }
+            else
+            {
+                uint64_t value = 0;
+
+                if (offset + sizeof(value) > data.size())
+                {
+                    return;
+                }
+
+                std::memcpy(&value, data.data() + offset, sizeof(value));
+                offset += sizeof(value);
+
+                if (field.type == Logger::Field::Type::Bool)
+                {
+                    field.boolValue = value != 0;
+                }
+                else
+                {
+                    field.uintValue = value;
+                }
+            }
+
+            fields.push_back(std::move(field));
+        }
+    }
+}
+
+Logger::RecordQueue::View::View(const RecordQueue& queue, uint64_t position, const Header& header) :
+    m_queue(queue),
+    m_position(position),
+    m_header(header)
+{
+
+}
+
+const Logger::RecordQueue::Header& Logger::RecordQueue::View::header() const
+{
+    return m_header;
+}
+
+Logger::RecordQueue::RecordQueue(std::size_t blocks) :
+    m_blocks(),
+    m_capacity(2),
+    m_enqueuePosition(0),
+    m_dequeuePosition(0)
+{
+    while (m_capacity < blocks)
+    {
+        m_capacity <<= 1;
+    }
+
+    m_blocks = std::make_unique<Block[]>(m_capacity);
+
+    for (uint64_t i = 0; i < m_capacity; ++i)
+    {
+        m_blocks[i].sequence.store(i, std::memory_order_relaxed);
+        m_blocks[i].blocks.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t Logger::RecordQueue::blocksCount(const AbstractLogger::Message& message)
+{
+    auto size = sizeof(Header) +
+                message.context.size() +
+                message.message.size() +
+                fieldsSize(message.fields) +
+                message.backtrace.size() * sizeof(void*) +
+                (message.span ? sizeof(uint64_t) : 0);
+
+    return (size + BlockDataSize - 1) / BlockDataSize;
+}
+
+bool Logger::RecordQueue::tryPush(const AbstractLogger::Message& message)
+{
+    Header header{};
+    header.timestamp = message.timestamp;
+    header.filename = message.filename;
+    header.thread = message.thread;
+    header.line = message.line;
+    header.contextSize = static_cast<uint32_t>(message.context.size());
+    header.messageSize = static_cast<uint32_t>(message.message.size());
+    header.fieldsSize = static_cast<uint32_t>(fieldsSize(message.fields));
+    header.errorClass = message.errorClass;
+    header.history = message.history;
+    header.span = message.span;
+    header.framesCount = static_cast<uint16_t>(message.backtrace.size());
+
+    // Message without raw timestamp keeps wall
+    // time in nanoseconds since epoch
+    if (header.timestamp == 0)
+    {
+        header.timestamp = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                message.timePoint.time_since_epoch()
+            ).count()
+        );
+    }
+
+    // Text, that does not fit into queue, is truncated
+    auto maximumSize = m_capacity * BlockDataSize - sizeof(Header);
+
+    auto framesSize = header.framesCount * sizeof(void*);
+
+    // Span duration is written after frames
+    auto spanSize = header.span ? sizeof(uint64_t) : 0;
+
+    maximumSize -= spanSize;
+
+    if (static_cast<std::size_t>(header.contextSize) + header.messageSize + header.fieldsSize + framesSize > maximumSize)
+    {
+        header.fieldsSize = 0;
+        header.framesCount = 0;
+        framesSize = 0;
+        header.contextSize = static_cast<uint32_t>(std::min<std::size_t>(header.contextSize, maximumSize / 2));
+        header.messageSize = static_cast<uint32_t>(std::min<std::size_t>(header.messageSize, maximumSize - header.contextSize));
+    }
+
+    uint64_t blocks = (sizeof(Header) + header.contextSize + header.messageSize + header.fieldsSize + framesSize +
+                       spanSize + BlockDataSize - 1) / BlockDataSize;
+
+    auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        int64_t difference = 0;
+
+        // Every block has to be released by consumer
+        for (uint64_t i = 0; i < blocks && difference == 0; ++i)
+        {
+            auto& block = m_blocks[(position + i) & (m_capacity - 1)];
+            difference = static_cast<int64_t>(block.sequence.load(std::memory_order_acquire) - (position + i));
+        }
+
+        if (difference == 0)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + blocks, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::size_t offset = 0;
+
+    writeBytes(position, offset, &header, sizeof(Header));
+    offset += sizeof(Header);
+
+    writeBytes(position, offset, message.context.data(), header.contextSize);
+    offset += header.contextSize;
+
+    writeBytes(position, offset, message.message.data(), header.messageSize);
+    offset += header.messageSize;
+
+    if (header.fieldsSize != 0)
+    {
+        static thread_local std::string packed;
+
+        packed.clear();
+        packFields(packed, message.fields);
+
+        writeBytes(position, offset, packed.data(), packed.size());
+        offset += packed.size();
+    }
+
+    writeBytes(position, offset, message.backtrace.data(), framesSize);
+    offset += framesSize;
+
+    writeBytes(position, offset, &message.spanDuration, spanSize);
+
+    auto& first = m_blocks[position & (m_capacity - 1)];
+
+    first.blocks.store(static_cast<uint32_t>(blocks), std::memory_order_relaxed);
+
+    // Other blocks are owned by message after moving of
+    // enqueue position, so only first one is published
+    first.sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool Logger::RecordQueue::tryPop(AbstractLogger::Message& message, uint64_t& position, uint64_t& blocks)
+{
+    position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        auto& block = m_blocks[position & (m_capacity - 1)];
+        auto sequence = block.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<int64_t>(sequence - (position + 1));
+
+        if (difference == 0)
+        {
+            blocks = block.blocks.load(std::memory_order_relaxed);
+
+            if (m_dequeuePosition.compare_exchange_weak(position, position + blocks, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = m_dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    Header header{};
+
+    std::size_t offset = 0;
+
+    readBytes(position, offset, &header, sizeof(Header));
+    offset += sizeof(Header);
+
+    message.timestamp = header.timestamp;
+    message.timePoint = std::chrono::system_clock::time_point();
+    message.errorClass = header.errorClass;
+    message.thread = header.thread;
+    message.filename = header.filename;
+    message.line = header.line;
+    message.history = header.history;
+    message.span = header.span;
+
+    // Strings keep their capacity
+    message.context.resize(header.contextSize);
+    readBytes(position, offset, &message.context[0], header.contextSize);
+    offset += header.contextSize;
+
+    message.message.resize(header.messageSize);
+    readBytes(position, offset, &message.message[0], header.messageSize);
+    offset += header.messageSize;
+
+    if (header.fieldsSize != 0)
+    {
+        static thread_local std::string packed;
+
+        packed.resize(header.fieldsSize);
+        readBytes(position, offset, &packed[0], header.fieldsSize);
+
+        unpackFields(packed, message.fields);
+        offset += header.fieldsSize;
+    }
+    else
+    {
+        message.fields.clear();
+    }
+
+    message.backtrace.resize(header.framesCount);
+    readBytes(position, offset, message.backtrace.data(), header.framesCount * sizeof(void*));
+    offset += header.framesCount * sizeof(void*);
+
+    message.spanDuration = 0;
+    readBytes(position, offset, &message.spanDuration, header.span ? sizeof(uint64_t) : 0);
+
+    for (uint64_t i = 0; i < blocks; ++i)
+    {
+        m_blocks[(position + i) & (m_capacity - 1)].sequence.store(
+            position + i + m_capacity,
+            std::memory_order_release
+        );
+    }
+
+    return true;
+}
+
+std::size_t Logger::RecordQueue::size() const
+{
+    auto dequeue = m_dequeuePosition.load();
+    auto enqueue = m_enqueuePosition.load();
+
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+}
+
+uint64_t Logger::RecordQueue::pushPosition() const
+{
+    return m_enqueuePosition.load();
+}
+
+bool Logger::RecordQueue::empty() const
+{
+    return size() == 0;
+}
+
+void Logger::RecordQueue::writeBytes(uint64_t position, std::size_t offset, const void* data, std::size_t size)
+{
+    auto source = static_cast<const char*>(data);
+
+    while (size != 0)
+    {
+        auto& block = m_blocks[(position + offset / BlockDataSize) & (m_capacity - 1)];
+        auto blockOffset = offset % BlockDataSize;
+        auto part = std::min(size, BlockDataSize - blockOffset);
+
+        std::memcpy(block.data + blockOffset, source, part);
+
+        source += part;
+        offset += part;
+        size -= part;
+    }
+}
+
+void Logger::RecordQueue::readBytes(uint64_t position, std::size_t offset, void* data, std::size_t size) const
+{
+    auto destination = static_cast<char*>(data);
+
+    while (size != 0)
+    {
+        auto& block = m_blocks[(position + offset / BlockDataSize) & (m_capacity - 1)];
+        auto blockOffset = offset % BlockDataSize;
+        auto part = std::min(size, BlockDataSize - blockOffset);
+
+        std::memcpy(destination, block.data + blockOffset, part);
+
+        destination += part;
+        offset += part;
+        size -= part;
+    }
+}
@@ -0,0 +1,388 @@
+#include <map>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+#include "Sinks/AbstractSink.hpp"
+#include "Formatters/PatternFormatter.hpp"
+#include "Categories.hpp"
+
+namespace
+{
+    /**
+     * @brief Thread, that commits sinks at requested
+     * time. So sink can finish it's periodic work
+     * (like sync or repeats line), while logger
+     * has no new messages. It's started by first
+     * request.
+     */
+    class CommitTimer
+    {
+    public:
+        CommitTimer() :
+            m_mutex(),
+            m_variable(),
+            m_sinks(),
+            m_working(true),
+            m_thread(&CommitTimer::run, this)
+        {
+
+        }
+
+        ~CommitTimer()
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_working = false;
+            }
+
+            m_variable.notify_all();
+            m_thread.join();
+        }
+
+        void schedule(std::chrono::steady_clock::time_point time, std::weak_ptr<Sinks::AbstractSink> sink)
+        {
+            bool earliest;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                earliest = m_sinks.empty() || time < m_sinks.begin()->first;
+
+                m_sinks.emplace(time, std::move(sink));
+            }
+
+            if (earliest)
+            {
+                m_variable.notify_all();
+            }
+        }
+
+    private:
+        void run()
+        {
+            std::vector<std::weak_ptr<Sinks::AbstractSink>> sinks;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (m_working)
+            {
+                if (m_sinks.empty())
+                {
+                    m_variable.wait(lock);
+                    continue;
+                }
+
+                auto now = std::chrono::steady_clock::now();
+
+                if (now < m_sinks.begin()->first)
+                {
+                    m_variable.wait_until(lock, m_sinks.begin()->first);
+                    continue;
+                }
+
+                while (!m_sinks.empty() && m_sinks.begin()->first <= now)
+                {
+                    sinks.push_back(std::move(m_sinks.begin()->second));
+                    m_sinks.erase(m_sinks.begin());
+                }
+
+                // Sink can request new commit
+                lock.unlock();
+
+                for (auto&& weak : sinks)
+                {
+                    if (auto sink = weak.lock())
+                    {
+                        sink->commit();
+                    }
+                }
+
+                sinks.clear();
+
+                lock.lock();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_variable;
+        std::multimap<std::chrono::steady_clock::time_point, std::weak_ptr<Sinks::AbstractSink>> m_sinks;
+        bool m_working;
+        std::thread m_thread;
+    };
+
+    CommitTimer& commitTimer()
+    {
+        static CommitTimer timer;
+
+        return timer;
+    }
+}
+
+Sinks::AbstractSink::AbstractSink() :
+    m_minErrorClass(AbstractLogger::ErrorClass::Info),
+    m_formatter(nullptr),
+    m_writeMutex(),
+    m_writeFormatter(nullptr),
+    m_collapseRepeats(false),
+    m_repeatsWindow(std::chrono::seconds(5)),
+    m_lastMessage(),
+    m_lastFormatter(nullptr),
+    m_hasLastMessage(false),
+    m_repeats(0),
+    m_repeatsStart(),
+    m_lastRepeat(),
+    m_commitTime()
+{
+
+}
+
+void Sinks::AbstractSink::setMinimumErrorClass(AbstractLogger::ErrorClass errorClass)
+{
+    m_minErrorClass = errorClass;
+
+    // Call sites cache levels of current logger sinks
+    Logger::Categories::invalidate();
+}
+
+AbstractLogger::ErrorClass Sinks::AbstractSink::minimumErrorClass() const
+{
+    return m_minErrorClass;
+}
+
+void Sinks::AbstractSink::setFormatter(Formatters::FormatterPtr formatter)
+{
+    m_formatter.store(std::move(formatter));
+}
+
+Formatters::FormatterPtr Sinks::AbstractSink::formatter() const
+{
+    return m_formatter.get();
+}
+
+void Sinks::AbstractSink::setFormat(std::string format)
+{
+    setFormatter(std::make_shared<Formatters::PatternFormatter>(std::move(format)));
+}
+
+void Sinks::AbstractSink::setRepeatsCollapsingEnabled(bool enabled)
+{
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    if (!enabled)
+    {
+        writeRepeats();
+
+        m_hasLastMessage = false;
+        m_lastFormatter = nullptr;
+    }
+
+    m_collapseRepeats = enabled;
+}
+
+bool Sinks::AbstractSink::repeatsCollapsingEnabled() const
+{
+    return m_collapseRepeats;
+}
+
+void Sinks::AbstractSink::setRepeatsWindow(std::chrono::milliseconds window)
+{
+    m_repeatsWindow = window;
+}
+
+std::chrono::milliseconds Sinks::AbstractSink::repeatsWindow() const
+{
+    return m_repeatsWindow;
+}
+
+bool Sinks::AbstractSink::accepts(AbstractLogger::ErrorClass errorClass) const
+{
+    return errorClass >= minimumErrorClass();
+}
+
+bool Sinks::AbstractSink::acceptsSpans() const
+{
+    return false;
+}
+
+void Sinks::AbstractSink::write(const AbstractLogger::Message& message,
+                                const std::string& formatted,
+                                const Formatters::FormatterPtr& formatter)
+{
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    if (!m_collapseRepeats)
+    {
+        m_writeFormatter = &formatter;
+        onWrite(message, formatted);
+        return;
+    }
+
+    if (isRepeat(message))
+    {
+        ++m_repeats;
+        m_lastRepeat = message.time();
+
+        auto window = m_repeatsWindow.load();
+
+        if (m_lastRepeat - m_repeatsStart >= window)
+        {
+            writeRepeats();
+        }
+        else if (m_repeats == 1)
+        {
+            // Repeats line is written by timer, if logger is idle
+            auto left = m_repeatsStart + window - std::chrono::system_clock::now();
+
+            commitAt(std::chrono::steady_clock::now() +
+                     std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::max(left, std::chrono::system_clock::duration::zero())
+                     ));
+        }
+
+        return;
+    }
+
+    writeRepeats();
+
+    // Assignment reuses strings memory
+    m_lastMessage = message;
+    m_lastFormatter = formatter;
+    m_hasLastMessage = true;
+    m_repeatsStart = message.time();
+
+    m_writeFormatter = &formatter;
+    onWrite(message, formatted);
+}
+
+void Sinks::AbstractSink::flushRepeats()
+{
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    if (m_repeats == 0)
+    {
+        return;
+    }
+
+    writeRepeats();
+
+    onCommit();
+}
+
+void Sinks::AbstractSink::commit()
+{
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    // Requested commit is done, sink can request new one
+    if (m_commitTime != std::chrono::steady_clock::time_point() &&
+        m_commitTime <= std::chrono::steady_clock::now())
+    {
+        m_commitTime = std::chrono::steady_clock::time_point();
+    }
+
+    // Run is not finished, but window is elapsed
+    if (m_repeats != 0 &&
+        std::chrono::system_clock::now() - m_repeatsStart >= m_repeatsWindow.load())
+    {
+        writeRepeats();
+    }
+
+    onCommit();
+}
+
+void Sinks::AbstractSink::waitForWritten()
+{
+
+}
+
+bool Sinks::AbstractSink::sync()
+{
+    waitForWritten();
+
+    std::unique_lock<std::mutex> lock(m_writeMutex);
+
+    writeRepeats();
+
+    return onSync();
+}
+
+bool Sinks::AbstractSink::isRepeat(const AbstractLogger::Message& message) const
+{
+    // Fields and span durations are
+    // data, they can't be collapsed
+    return m_hasLastMessage &&
+           !message.span &&
+           !m_lastMessage.span &&
+           message.fields.empty() &&
+           m_lastMessage.fields.empty() &&
+           message.filename == m_lastMessage.filename &&
+           message.line == m_lastMessage.line &&
+           message.errorClass == m_lastMessage.errorClass &&
+           message.message == m_lastMessage.message &&
+           message.context == m_lastMessage.context;
+}
+
+void Sinks::AbstractSink::writeRepeats()
+{
+    if (m_repeats == 0)
+    {
+        return;
+    }
+
+    AbstractLogger::Message repeats = m_lastMessage;
+
+    repeats.timestamp = 0;
+    repeats.timePoint = m_lastRepeat;
+    repeats.message = "last message repeated " + std::to_string(m_repeats) + " times";
+
+    m_writeFormatter = &m_lastFormatter;
+
+    if (m_lastFormatter != nullptr)
+    {
+        onWrite(repeats, m_lastFormatter->format(repeats));
+    }
+    else
+    {
+        onWrite(repeats, repeats.message);
+    }
+
+    m_repeats = 0;
+    m_repeatsStart = m_lastRepeat;
+}
+
+void Sinks::AbstractSink::commitAt(std::chrono::steady_clock::time_point time)
+{
+    // Earlier commit is already requested
+    if (m_commitTime != std::chrono::steady_clock::time_point() &&
+        m_commitTime <= time)
+    {
+        return;
+    }
+
+    auto sink = weak_from_this();
+
+    if (sink.expired())
+    {
+        return;
+    }
+
+    m_commitTime = time;
+
+    commitTimer().schedule(time, std::move(sink));
+}
+
+const Formatters::FormatterPtr& Sinks::AbstractSink::writeFormatter() const
+{
+    static const Formatters::FormatterPtr empty;
+
+    return m_writeFormatter != nullptr ? *m_writeFormatter : empty;
+}
+
+void Sinks::AbstractSink::onCommit()
+{
+
+}
+
+bool Sinks::AbstractSink::onSync()
+{
+    return true;
+}
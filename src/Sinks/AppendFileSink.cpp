@@ -0,0 +1,156 @@
+#include <cerrno>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <SystemTools.h>
+#include "Sinks/AppendFileSink.hpp"
+
+Sinks::AppendFileSink::AppendFileSink() :
+    m_fd(-1),
+    m_path(),
+    m_line(),
+    m_maximumLineSize(64 * 1024)
+{
+
+}
+
+Sinks::AppendFileSink::~AppendFileSink()
+{
+    closeFile();
+}
+
+void Sinks::AppendFileSink::setMaximumLineSize(std::size_t bytes)
+{
+    m_maximumLineSize = std::max<std::size_t>(bytes, 2);
+}
+
+std::size_t Sinks::AppendFileSink::maximumLineSize() const
+{
+    return m_maximumLineSize;
+}
+
+void Sinks::AppendFileSink::onCommit()
+{
+    FileSink::onCommit();
+
+    if (m_fd < 0)
+    {
+        return;
+    }
+
+    // Other processes write to same file, so size
+    // is taken from file. File is reopened, if it was
+    // rotated by other process.
+    struct stat openedStat{};
+    struct stat pathStat{};
+
+    if (fstat(m_fd, &openedStat) != 0 ||
+        ::stat(m_path.c_str(), &pathStat) != 0 ||
+        openedStat.st_ino != pathStat.st_ino ||
+        openedStat.st_dev != pathStat.st_dev ||
+        (maximumLogFile() != 0 && static_cast<uint64_t>(openedStat.st_size) > maximumLogFile()))
+    {
+        closeFile();
+    }
+}
+
+std::string Sinks::AppendFileSink::getLogPath() const
+{
+    auto lockPath = SystemTools::Path::join(logPath(), "log.txt.lock");
+
+    auto lockFd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    if (lockFd < 0)
+    {
+        return FileSink::getLogPath();
+    }
+
+    flock(lockFd, LOCK_EX);
+
+    auto path = FileSink::getLogPath();
+
+    // Lock is released by close
+    ::close(lockFd);
+
+    return path;
+}
+
+int64_t Sinks::AppendFileSink::openFile(const std::string& path)
+{
+    m_fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+
+    if (m_fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat fileStat{};
+
+    if (fstat(m_fd, &fileStat) != 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        return -1;
+    }
+
+    m_path = path;
+
+    return static_cast<int64_t>(fileStat.st_size);
+}
+
+void Sinks::AppendFileSink::closeFile()
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+
+    ::close(m_fd);
+
+    m_fd = -1;
+}
+
+bool Sinks::AppendFileSink::isFileOpened() const
+{
+    return m_fd >= 0;
+}
+
+void Sinks::AppendFileSink::writeLine(const std::string& formatted)
+{
+    // Buffer is reused, line is written at once
+    m_line.assign(formatted, 0, std::min(formatted.size(), m_maximumLineSize.load() - 1));
+    m_line += '\n';
+
+    const char* data = m_line.data();
+    auto size = m_line.size();
+
+    while (size > 0)
+    {
+        auto written = ::write(m_fd, data, size);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return;
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void Sinks::AppendFileSink::flushFile()
+{
+    // Lines are not buffered
+}
+
+bool Sinks::AppendFileSink::syncFile()
+{
+    return fdatasync(m_fd) == 0;
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include "Sinks/AsyncSink.hpp"
+
+Sinks::AsyncSink::AsyncSink(SinkPtr sink, std::size_t capacity, Overflow overflow) :
+    m_sink(std::move(sink)),
+    m_working(true),
+    m_writing(false),
+    m_entries(),
+    m_capacity(std::max<std::size_t>(capacity, 1)),
+    m_overflow(overflow),
+    m_dropped(0),
+    m_entriesMutex(),
+    m_cond(),
+    m_clearVariable(),
+    m_spaceVariable(),
+    m_thread()
+{
+    m_thread = std::thread(&Sinks::AsyncSink::writingThread, this);
+}
+
+Sinks::AsyncSink::~AsyncSink()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_entriesMutex);
+        m_working = false;
+    }
+
+    m_cond.notify_one();
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+Sinks::SinkPtr Sinks::AsyncSink::sink() const
+{
+    return m_sink;
+}
+
+uint64_t Sinks::AsyncSink::droppedMessages() const
+{
+    return m_dropped;
+}
+
+void Sinks::AsyncSink::setMinimumErrorClass(AbstractLogger::ErrorClass errorClass)
+{
+    m_sink->setMinimumErrorClass(errorClass);
+}
+
+AbstractLogger::ErrorClass Sinks::AsyncSink::minimumErrorClass() const
+{
+    return m_sink->minimumErrorClass();
+}
+
+bool Sinks::AsyncSink::acceptsSpans() const
+{
+    return m_sink->acceptsSpans();
+}
+
+void Sinks::AsyncSink::setFormatter(Formatters::FormatterPtr formatter)
+{
+    m_sink->setFormatter(std::move(formatter));
+}
+
+Formatters::FormatterPtr Sinks::AsyncSink::formatter() const
+{
+    return m_sink->formatter();
+}
+
+void Sinks::AsyncSink::waitForWritten()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_entriesMutex);
+
+        while (!m_entries.empty() || m_writing)
+        {
+            m_clearVariable.wait(lock);
+        }
+    }
+
+    m_sink->waitForWritten();
+}
+
+void Sinks::AsyncSink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_entriesMutex);
+
+        while (m_entries.size() >= m_capacity)
+        {
+            if (m_overflow == Overflow::Drop)
+            {
+                ++m_dropped;
+                return;
+            }
+
+            m_spaceVariable.wait(lock);
+        }
+
+        m_entries.push({message, formatted, writeFormatter()});
+    }
+
+    m_cond.notify_one();
+}
+
+bool Sinks::AsyncSink::onSync()
+{
+    return m_sink->sync();
+}
+
+void Sinks::AsyncSink::writingThread()
+{
+    std::unique_lock<std::mutex> lock(m_entriesMutex);
+
+    while (true)
+    {
+        while (m_entries.empty() && m_working)
+        {
+            m_cond.wait(lock);
+        }
+
+        // Queue is drained on destruction
+        if (m_entries.empty())
+        {
+            break;
+        }
+
+        m_writing = true;
+
+        while (!m_entries.empty())
+        {
+            auto entry = std::move(m_entries.front());
+            m_entries.pop();
+
+            if (m_entries.size() + 1 == m_capacity)
+            {
+                m_spaceVariable.notify_all();
+            }
+
+            lock.unlock();
+
+            m_sink->write(entry.message, entry.formatted, entry.formatter);
+
+            lock.lock();
+        }
+
+        lock.unlock();
+
+        m_sink->commit();
+
+        lock.lock();
+
+        m_writing = false;
+
+        m_clearVariable.notify_all();
+    }
+}
@@ -0,0 +1,83 @@
+#include <stdexcept>
+#include "Sinks/ChromeTraceSink.hpp"
+#include "Formatters/ChromeTraceFormatter.hpp"
+#include "Formatters/JsonLinesFormatter.hpp"
+#include "Threads.hpp"
+
+Sinks::ChromeTraceSink::ChromeTraceSink(const std::string& path) :
+    m_file(path, std::ios::out | std::ios::trunc | std::ios::binary),
+    m_buffer(),
+    m_empty(true),
+    m_namedThreads()
+{
+    if (!m_file.is_open())
+    {
+        throw std::runtime_error("Can't open trace file \"" + path + "\"");
+    }
+
+    setMinimumErrorClass(AbstractLogger::ErrorClass::Warning);
+    setFormatter(std::make_shared<Formatters::ChromeTraceFormatter>());
+
+    m_file << '[';
+    m_file.flush();
+}
+
+Sinks::ChromeTraceSink::~ChromeTraceSink()
+{
+    m_file << m_buffer << "\n]\n";
+}
+
+bool Sinks::ChromeTraceSink::acceptsSpans() const
+{
+    return true;
+}
+
+void Sinks::ChromeTraceSink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    auto threadId = Formatters::ChromeTraceFormatter::threadId(message.thread);
+
+    // Thread can be named after it's first events,
+    // so unnamed threads are checked every time
+    if (m_namedThreads.count(threadId) == 0)
+    {
+        auto& thread = Logger::Threads::render(message.thread);
+
+        if (thread.name != thread.id)
+        {
+            std::string event = "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":";
+            event.append(std::to_string(Formatters::ChromeTraceFormatter::processId()));
+            event.append(",\"tid\":");
+            event.append(std::to_string(threadId));
+            event.append(",\"args\":{\"name\":");
+            Formatters::JsonLinesFormatter::appendString(event, thread.name);
+            event.append("}}");
+
+            appendEvent(event);
+
+            m_namedThreads.insert(threadId);
+        }
+    }
+
+    appendEvent(formatted);
+}
+
+void Sinks::ChromeTraceSink::onCommit()
+{
+    if (m_buffer.empty())
+    {
+        return;
+    }
+
+    m_file << m_buffer;
+    m_file.flush();
+
+    m_buffer.clear();
+}
+
+void Sinks::ChromeTraceSink::appendEvent(const std::string& event)
+{
+    m_buffer.append(m_empty ? "\n" : ",\n");
+    m_buffer.append(event);
+
+    m_empty = false;
+}
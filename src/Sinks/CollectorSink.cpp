@@ -0,0 +1,198 @@
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Sinks/CollectorSink.hpp"
+#include "Collector.hpp"
+
+Sinks::CollectorSink::CollectorSink(std::string socketPath, SinkPtr fallback) :
+    m_socketPath(std::move(socketPath)),
+    m_fallback(std::move(fallback)),
+    m_fd(-1),
+    m_datagram(),
+    m_nextConnect()
+{
+    m_datagram.reserve(Logger::Collector::MaximumDatagramSize);
+}
+
+Sinks::CollectorSink::~CollectorSink()
+{
+    send();
+
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+
+    if (m_fallback != nullptr)
+    {
+        m_fallback->commit();
+    }
+}
+
+const std::string& Sinks::CollectorSink::socketPath() const
+{
+    return m_socketPath;
+}
+
+bool Sinks::CollectorSink::isConnected() const
+{
+    return m_fd >= 0;
+}
+
+void Sinks::CollectorSink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    if (m_fd < 0 && !connect())
+    {
+        if (m_fallback != nullptr)
+        {
+            m_fallback->write(message, formatted);
+        }
+
+        return;
+    }
+
+    auto size = std::min(
+        formatted.size(),
+        Logger::Collector::MaximumDatagramSize - Logger::Collector::RecordHeaderSize
+    );
+
+    if (m_datagram.size() + Logger::Collector::RecordHeaderSize + size > Logger::Collector::MaximumDatagramSize)
+    {
+        send();
+
+        if (m_fd < 0)
+        {
+            if (m_fallback != nullptr)
+            {
+                m_fallback->write(message, formatted);
+            }
+
+            return;
+        }
+    }
+
+    auto textSize = static_cast<uint32_t>(size);
+
+    m_datagram.append(reinterpret_cast<const char*>(&textSize), sizeof(textSize));
+    m_datagram.push_back(static_cast<char>(message.errorClass));
+    m_datagram.append(formatted, 0, size);
+}
+
+void Sinks::CollectorSink::onCommit()
+{
+    send();
+
+    if (m_fallback != nullptr)
+    {
+        m_fallback->commit();
+    }
+}
+
+bool Sinks::CollectorSink::onSync()
+{
+    send();
+
+    // Collector durability is not controlled
+    // by sender, only fallback can be synced
+    if (m_fallback != nullptr)
+    {
+        return m_fallback->sync();
+    }
+
+    return true;
+}
+
+bool Sinks::CollectorSink::connect()
+{
+    auto now = std::chrono::steady_clock::now();
+
+    if (now < m_nextConnect)
+    {
+        return false;
+    }
+
+    m_nextConnect = now + std::chrono::seconds(1);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (m_socketPath.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+
+    std::memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size() + 1);
+
+    auto fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+
+    return true;
+}
+
+void Sinks::CollectorSink::send()
+{
+    if (m_datagram.empty())
+    {
+        return;
+    }
+
+    while (m_fd >= 0 &&
+           ::send(m_fd, m_datagram.data(), m_datagram.size(), MSG_NOSIGNAL) < 0)
+    {
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        // Collector is gone
+        ::close(m_fd);
+        m_fd = -1;
+
+        m_nextConnect = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+        writeFallback();
+    }
+
+    m_datagram.clear();
+}
+
+void Sinks::CollectorSink::writeFallback()
+{
+    if (m_fallback == nullptr)
+    {
+        return;
+    }
+
+    AbstractLogger::Message message;
+    message.timePoint = std::chrono::system_clock::now();
+
+    std::size_t offset = 0;
+
+    while (offset + Logger::Collector::RecordHeaderSize <= m_datagram.size())
+    {
+        uint32_t textSize = 0;
+        std::memcpy(&textSize, m_datagram.data() + offset, sizeof(textSize));
+
+        message.errorClass = static_cast<AbstractLogger::ErrorClass>(m_datagram[offset + 4]);
+        message.message.assign(m_datagram, offset + Logger::Collector::RecordHeaderSize, textSize);
+
+        m_fallback->write(message, message.message);
+
+        offset += Logger::Collector::RecordHeaderSize + textSize;
+    }
+}
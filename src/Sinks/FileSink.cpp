@@ -0,0 +1,294 @@
+#include <limits>
+#include <cstdio>
+#include <SystemTools.h>
+#include "Sinks/FileSink.hpp"
+
+#ifdef OS_LINUX
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+Sinks::FileSink::FileSink() :
+    m_outputFile(),
+    m_outputFileSize(0),
+    m_syncDescriptor(-1),
+    m_durability(Durability::None),
+    m_syncInterval(std::chrono::seconds(1)),
+    m_lastSync(),
+    m_hasUnsyncedData(false),
+    m_hasDurableMessages(false),
+    m_syncFailed(false),
+    m_maxLogFileSizeBytes(static_cast<uint64_t>(2 * 1024 * 1024)),
+    m_fileLogPath("logs")
+{
+
+}
+
+Sinks::FileSink::~FileSink()
+{
+    // Derived classes close their files by themselves
+    Sinks::FileSink::closeFile();
+}
+
+void Sinks::FileSink::setDurability(Sinks::FileSink::Durability durability)
+{
+    m_durability = durability;
+}
+
+Sinks::FileSink::Durability Sinks::FileSink::durability() const
+{
+    return m_durability;
+}
+
+void Sinks::FileSink::setSyncInterval(std::chrono::milliseconds interval)
+{
+    m_syncInterval = interval;
+}
+
+std::chrono::milliseconds Sinks::FileSink::syncInterval() const
+{
+    return m_syncInterval;
+}
+
+void Sinks::FileSink::setLogPath(std::string path)
+{
+    m_fileLogPath.store(std::move(path));
+}
+
+std::string Sinks::FileSink::logPath() const
+{
+    return m_fileLogPath.get();
+}
+
+void Sinks::FileSink::setMaximumLogFile(uint64_t bytes)
+{
+    m_maxLogFileSizeBytes = bytes;
+}
+
+uint64_t Sinks::FileSink::maximumLogFile() const
+{
+    return m_maxLogFileSizeBytes;
+}
+
+void Sinks::FileSink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    uint64_t maximumSize = m_maxLogFileSizeBytes;
+
+    // Closing file, if it has to be rotated
+    if (isFileOpened() &&
+        maximumSize != 0 &&
+        m_outputFileSize > maximumSize)
+    {
+        // Rotated file will not be synced later
+        if (m_durability != Durability::None)
+        {
+            syncIfRequired();
+        }
+
+        closeFile();
+    }
+
+    if (!isFileOpened())
+    {
+        auto size = openFile(getLogPath());
+
+        if (size < 0)
+        {
+            return;
+        }
+
+        m_outputFileSize = static_cast<uint64_t>(size);
+    }
+
+    writeLine(formatted);
+    m_outputFileSize += formatted.size() + 1;
+
+    m_hasUnsyncedData = true;
+
+    if (message.errorClass >= AbstractLogger::ErrorClass::Error)
+    {
+        m_hasDurableMessages = true;
+    }
+}
+
+void Sinks::FileSink::onCommit()
+{
+    if (!isFileOpened())
+    {
+        return;
+    }
+
+    flushFile();
+
+    switch (m_durability)
+    {
+    case Durability::None:
+        break;
+    case Durability::Periodic:
+        if (std::chrono::steady_clock::now() - m_lastSync >= m_syncInterval.load())
+        {
+            syncIfRequired();
+        }
+        else if (m_hasUnsyncedData)
+        {
+            // Last batch before idle period is synced by timer
+            commitAt(m_lastSync + m_syncInterval.load());
+        }
+        break;
+    case Durability::GroupCommit:
+        // One sync covers whole batch
+        if (m_hasDurableMessages)
+        {
+            syncIfRequired();
+        }
+        break;
+    }
+
+    m_hasDurableMessages = false;
+}
+
+bool Sinks::FileSink::onSync()
+{
+    if (isFileOpened())
+    {
+        flushFile();
+        syncIfRequired();
+    }
+
+    // Failure of batch or rotation sync is reported too
+    auto synced = !m_syncFailed;
+
+    m_syncFailed = false;
+
+    return synced;
+}
+
+void Sinks::FileSink::syncIfRequired()
+{
+    if (!m_hasUnsyncedData)
+    {
+        return;
+    }
+
+    if (!syncFile())
+    {
+        m_syncFailed = true;
+    }
+
+    m_hasUnsyncedData = false;
+    m_lastSync = std::chrono::steady_clock::now();
+}
+
+int64_t Sinks::FileSink::openFile(const std::string& path)
+{
+    m_outputFile.open(path, std::ios_base::out | std::ios_base::app);
+
+    if (!m_outputFile.is_open())
+    {
+        return -1;
+    }
+
+#ifdef OS_LINUX
+    // Stream has no descriptor access, so file is opened
+    // once more. Descriptor is checked to be same file,
+    // so it stays valid after rename of log file.
+    m_syncDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    struct stat descriptorStat{};
+    struct stat pathStat{};
+
+    if (m_syncDescriptor >= 0 &&
+        (fstat(m_syncDescriptor, &descriptorStat) != 0 ||
+         ::stat(path.c_str(), &pathStat) != 0 ||
+         descriptorStat.st_dev != pathStat.st_dev ||
+         descriptorStat.st_ino != pathStat.st_ino))
+    {
+        ::close(m_syncDescriptor);
+        m_syncDescriptor = -1;
+    }
+#endif
+
+    return static_cast<int64_t>(SystemTools::Path::getFileSize(path));
+}
+
+void Sinks::FileSink::closeFile()
+{
+    m_outputFile.close();
+
+#ifdef OS_LINUX
+    if (m_syncDescriptor >= 0)
+    {
+        ::close(m_syncDescriptor);
+        m_syncDescriptor = -1;
+    }
+#endif
+}
+
+bool Sinks::FileSink::isFileOpened() const
+{
+    return m_outputFile.is_open();
+}
+
+void Sinks::FileSink::writeLine(const std::string& formatted)
+{
+    m_outputFile << formatted << '\n';
+}
+
+void Sinks::FileSink::flushFile()
+{
+    m_outputFile.flush();
+}
+
+bool Sinks::FileSink::syncFile()
+{
+    if (!m_outputFile.good())
+    {
+        return false;
+    }
+
+#ifdef OS_LINUX
+    // Sync of any descriptor of file syncs all it's data
+    return m_syncDescriptor >= 0 && fdatasync(m_syncDescriptor) == 0;
+#endif
+#ifdef OS_WINDOWS
+    // Only stream buffer is flushed on windows
+    return true;
+#endif
+}
+
+std::string Sinks::FileSink::getLogPath() const
+{
+    // Opening current file
+    std::string path = SystemTools::Path::join(m_fileLogPath.get(), "log.txt");
+
+    uint64_t maximumSize = m_maxLogFileSizeBytes;
+
+    if (maximumSize == 0)
+    {
+        return path;
+    }
+
+    auto filesize = static_cast<uint64_t>(SystemTools::Path::getFileSize(path));
+
+    if (filesize > maximumSize)
+    {
+        uint64_t i;
+        // Renaming to new one
+        for (i = 0;
+             i < std::numeric_limits<uint64_t>::max() &&
+             SystemTools::Path::fileExists(path + "_" + std::to_string(i + 1));
+             ++i)
+        {}
+
+        // Ok, we received end
+        if (i == std::numeric_limits<uint64_t>::max())
+        {
+            return "";
+        }
+
+        std::rename(path.c_str(), (path + "_" + std::to_string(i + 1)).c_str());
+    }
+
+    return path;
+}
@@ -0,0 +1,171 @@
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Sinks/MappedFileSink.hpp"
+
+Sinks::MappedFileSink::MappedFileSink() :
+    m_fd(-1),
+    m_data(nullptr),
+    m_length(0),
+    m_capacity(0),
+    m_preallocationSize(1024 * 1024)
+{
+
+}
+
+Sinks::MappedFileSink::~MappedFileSink()
+{
+    closeFile();
+}
+
+void Sinks::MappedFileSink::setPreallocationSize(uint64_t bytes)
+{
+    m_preallocationSize = bytes;
+}
+
+uint64_t Sinks::MappedFileSink::preallocationSize() const
+{
+    return m_preallocationSize;
+}
+
+int64_t Sinks::MappedFileSink::openFile(const std::string& path)
+{
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    if (m_fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat fileStat{};
+
+    if (fstat(m_fd, &fileStat) != 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        return -1;
+    }
+
+    m_length = static_cast<uint64_t>(fileStat.st_size);
+
+    // If previous process was killed, file may
+    // contain preallocated zeros at the end.
+    if (m_length > 0 && reserve(m_length))
+    {
+        while (m_length > 0 && m_data[m_length - 1] == '\0')
+        {
+            --m_length;
+        }
+    }
+
+    return static_cast<int64_t>(m_length);
+}
+
+void Sinks::MappedFileSink::closeFile()
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+
+    if (m_data != nullptr)
+    {
+        munmap(m_data, m_capacity);
+    }
+
+    // Removing preallocated tail
+    if (ftruncate(m_fd, static_cast<off_t>(m_length)) != 0)
+    {
+        // Nothing can be done here, tail will
+        // be trimmed on next opening.
+    }
+
+    ::close(m_fd);
+
+    m_fd = -1;
+    m_data = nullptr;
+    m_length = 0;
+    m_capacity = 0;
+}
+
+bool Sinks::MappedFileSink::isFileOpened() const
+{
+    return m_fd >= 0;
+}
+
+void Sinks::MappedFileSink::writeLine(const std::string& formatted)
+{
+    if (!reserve(m_length + formatted.size() + 1))
+    {
+        return;
+    }
+
+    std::memcpy(m_data + m_length, formatted.data(), formatted.size());
+    m_data[m_length + formatted.size()] = '\n';
+
+    m_length += formatted.size() + 1;
+}
+
+void Sinks::MappedFileSink::flushFile()
+{
+    // Mapped pages are already visible to
+    // everyone through page cache.
+}
+
+bool Sinks::MappedFileSink::syncFile()
+{
+    // Dirty mapped pages are written by fdatasync too
+    return fdatasync(m_fd) == 0;
+}
+
+bool Sinks::MappedFileSink::reserve(uint64_t bytes)
+{
+    if (bytes <= m_capacity)
+    {
+        return true;
+    }
+
+    auto chunk = std::max<uint64_t>(m_preallocationSize, static_cast<uint64_t>(sysconf(_SC_PAGESIZE)));
+    auto capacity = ((bytes + chunk - 1) / chunk) * chunk;
+
+    if (fallocate(m_fd, 0, 0, static_cast<off_t>(capacity)) != 0)
+    {
+        // Falling back to sparse file only if file system
+        // does not support preallocation. Store into sparse
+        // page on full disk will raise SIGBUS.
+        if (errno != EOPNOTSUPP && errno != ENOSYS)
+        {
+            return false;
+        }
+
+        if (ftruncate(m_fd, static_cast<off_t>(capacity)) != 0)
+        {
+            return false;
+        }
+    }
+
+    void* data;
+
+    if (m_data == nullptr)
+    {
+        data = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    }
+    else
+    {
+        data = mremap(m_data, m_capacity, capacity, MREMAP_MAYMOVE);
+    }
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<char*>(data);
+    m_capacity = capacity;
+
+    return true;
+}
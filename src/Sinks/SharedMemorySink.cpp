@@ -0,0 +1,374 @@
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <SystemTools.h>
+#include "Sinks/SharedMemorySink.hpp"
+
+// Records area starts after header on separate cache line
+static constexpr std::size_t DataOffset = 64;
+
+static_assert(sizeof(Sinks::SharedMemorySink::Header) <= DataOffset, "Header does not fit");
+
+// Commit value of padding records
+static constexpr uint64_t PaddingCommit = ~0ULL;
+
+static uint64_t recordSize(uint64_t textSize)
+{
+    return (sizeof(Sinks::SharedMemorySink::RecordHeader) + textSize + 7) & ~7ULL;
+}
+
+static int64_t systemNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+Sinks::SharedMemorySink::SharedMemorySink(std::string name, std::size_t capacity) :
+    m_name(std::move(name)),
+    m_mappedSize(0),
+    m_header(nullptr),
+    m_data(nullptr),
+    m_capacity((capacity + 7) & ~static_cast<std::size_t>(7)),
+    m_sequence(0)
+{
+    if (m_capacity < 1024)
+    {
+        throw std::runtime_error("Shared memory ring is too small.");
+    }
+
+    auto fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    if (fd < 0)
+    {
+        throw std::runtime_error("Can't open shared memory: " + SystemTools::getLastErrorString());
+    }
+
+    m_mappedSize = DataOffset + m_capacity;
+
+    struct stat objectStat{};
+
+    bool reuse = fstat(fd, &objectStat) == 0 &&
+                 static_cast<std::size_t>(objectStat.st_size) == m_mappedSize;
+
+    if (!reuse && ftruncate(fd, static_cast<off_t>(m_mappedSize)) != 0)
+    {
+        auto error = SystemTools::getLastErrorString();
+        ::close(fd);
+        throw std::runtime_error("Can't resize shared memory: " + error);
+    }
+
+    auto address = mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Can't map shared memory: " + SystemTools::getLastErrorString());
+    }
+
+    m_header = static_cast<Header*>(address);
+    m_data = static_cast<char*>(address) + DataOffset;
+
+    if (reuse &&
+        m_header->magic == Magic &&
+        m_header->capacity == m_capacity)
+    {
+        // Continuing records of previous process
+        auto head = m_header->headPosition.load();
+
+        for (auto position = m_header->tailPosition.load(); position < head;)
+        {
+            auto remaining = m_capacity - position % m_capacity;
+
+            if (remaining < sizeof(RecordHeader))
+            {
+                position += remaining;
+                continue;
+            }
+
+            auto record = recordAt(position);
+            auto commit = record->commit.load();
+
+            if (record->errorClass == PaddingRecord)
+            {
+                position += remaining;
+                continue;
+            }
+
+            if (commit != 0)
+            {
+                m_sequence = commit;
+            }
+
+            position += recordSize(record->size);
+        }
+    }
+    else
+    {
+        std::memset(address, 0, DataOffset);
+
+        m_header->capacity = m_capacity;
+        m_header->tailPosition = 0;
+        m_header->headPosition = 0;
+        m_header->magic = Magic;
+    }
+
+    m_header->pid = getpid();
+}
+
+Sinks::SharedMemorySink::~SharedMemorySink()
+{
+    munmap(m_header, m_mappedSize);
+}
+
+const std::string& Sinks::SharedMemorySink::name() const
+{
+    return m_name;
+}
+
+void Sinks::SharedMemorySink::remove(const std::string& name)
+{
+    shm_unlink(name.c_str());
+}
+
+Sinks::SharedMemorySink::RecordHeader* Sinks::SharedMemorySink::recordAt(uint64_t position) const
+{
+    return reinterpret_cast<RecordHeader*>(m_data + position % m_capacity);
+}
+
+void Sinks::SharedMemorySink::releaseSpace(uint64_t end)
+{
+    auto tail = m_header->tailPosition.load(std::memory_order_relaxed);
+
+    if (end - tail <= m_capacity)
+    {
+        return;
+    }
+
+    while (end - tail > m_capacity)
+    {
+        auto remaining = m_capacity - tail % m_capacity;
+
+        if (remaining < sizeof(RecordHeader) ||
+            recordAt(tail)->errorClass == PaddingRecord)
+        {
+            tail += remaining;
+            continue;
+        }
+
+        tail += recordSize(recordAt(tail)->size);
+    }
+
+    m_header->tailPosition.store(tail, std::memory_order_relaxed);
+
+    // Readers see new tail before overwritten data
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void Sinks::SharedMemorySink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    auto size = std::min<uint64_t>(formatted.size(), m_capacity / 4 - sizeof(RecordHeader));
+    auto total = recordSize(size);
+
+    auto position = m_header->headPosition.load(std::memory_order_relaxed);
+    auto remaining = m_capacity - position % m_capacity;
+
+    // Records are not split, rest of ring is skipped
+    if (remaining < total)
+    {
+        releaseSpace(position + remaining);
+
+        if (remaining >= sizeof(RecordHeader))
+        {
+            auto padding = recordAt(position);
+
+            padding->commit.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            padding->time = 0;
+            padding->size = 0;
+            padding->errorClass = PaddingRecord;
+
+            padding->commit.store(PaddingCommit, std::memory_order_release);
+        }
+
+        position += remaining;
+
+        m_header->headPosition.store(position, std::memory_order_release);
+    }
+
+    releaseSpace(position + total);
+
+    auto record = recordAt(position);
+
+    record->commit.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record->time = systemNanoseconds();
+    record->size = static_cast<uint32_t>(size);
+    record->errorClass = static_cast<uint8_t>(message.errorClass);
+
+    std::memcpy(reinterpret_cast<char*>(record) + sizeof(RecordHeader), formatted.data(), size);
+
+    record->commit.store(++m_sequence, std::memory_order_release);
+
+    m_header->headPosition.store(position + total, std::memory_order_release);
+}
+
+Sinks::SharedMemoryReader::SharedMemoryReader(const std::string& name) :
+    m_mappedSize(0),
+    m_header(nullptr),
+    m_data(nullptr),
+    m_capacity(0),
+    m_position(0),
+    m_lastSequence(0),
+    m_dropped(0)
+{
+    auto fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+
+    if (fd < 0)
+    {
+        throw std::runtime_error("Can't open shared memory: " + SystemTools::getLastErrorString());
+    }
+
+    struct stat objectStat{};
+
+    if (fstat(fd, &objectStat) != 0 ||
+        static_cast<std::size_t>(objectStat.st_size) <= DataOffset)
+    {
+        ::close(fd);
+        throw std::runtime_error("Shared memory object is not a log ring.");
+    }
+
+    m_mappedSize = static_cast<std::size_t>(objectStat.st_size);
+
+    auto address = mmap(nullptr, m_mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        throw std::runtime_error("Can't map shared memory: " + SystemTools::getLastErrorString());
+    }
+
+    m_header = static_cast<const SharedMemorySink::Header*>(address);
+    m_data = static_cast<const char*>(address) + DataOffset;
+    m_capacity = m_header->capacity;
+
+    if (m_header->magic != SharedMemorySink::Magic ||
+        m_capacity + DataOffset != m_mappedSize)
+    {
+        munmap(address, m_mappedSize);
+        throw std::runtime_error("Shared memory object is not a log ring.");
+    }
+}
+
+Sinks::SharedMemoryReader::~SharedMemoryReader()
+{
+    munmap(const_cast<SharedMemorySink::Header*>(m_header), m_mappedSize);
+}
+
+std::size_t Sinks::SharedMemoryReader::read(std::vector<Record>& records)
+{
+    records.clear();
+
+    auto head = m_header->headPosition.load(std::memory_order_acquire);
+
+    while (m_position < head)
+    {
+        auto tail = m_header->tailPosition.load(std::memory_order_acquire);
+
+        if (m_position < tail)
+        {
+            m_position = tail;
+            continue;
+        }
+
+        auto remaining = m_capacity - m_position % m_capacity;
+
+        if (remaining < sizeof(SharedMemorySink::RecordHeader))
+        {
+            m_position += remaining;
+            continue;
+        }
+
+        auto header = reinterpret_cast<const SharedMemorySink::RecordHeader*>(
+            m_data + m_position % m_capacity
+        );
+
+        auto commit = header->commit.load(std::memory_order_acquire);
+
+        if (commit == 0)
+        {
+            // Record is being overwritten
+            if (m_header->tailPosition.load(std::memory_order_acquire) > m_position)
+            {
+                continue;
+            }
+
+            // Writer was killed inside of record
+            break;
+        }
+
+        auto size = std::min<uint64_t>(header->size, remaining - sizeof(SharedMemorySink::RecordHeader));
+        auto padding = header->errorClass == SharedMemorySink::PaddingRecord;
+
+        Record record;
+
+        record.sequence = commit;
+        record.timePoint = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(header->time)
+            )
+        );
+        record.errorClass = static_cast<AbstractLogger::ErrorClass>(header->errorClass);
+        record.text.assign(reinterpret_cast<const char*>(header + 1), size);
+
+        // Record could be overwritten while copying
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (m_header->tailPosition.load(std::memory_order_relaxed) > m_position ||
+            header->commit.load(std::memory_order_relaxed) != commit)
+        {
+            continue;
+        }
+
+        if (padding)
+        {
+            m_position += remaining;
+            continue;
+        }
+
+        m_position += recordSize(size);
+
+        if (m_lastSequence != 0 && record.sequence > m_lastSequence + 1)
+        {
+            m_dropped += record.sequence - m_lastSequence - 1;
+        }
+
+        m_lastSequence = record.sequence;
+
+        records.push_back(std::move(record));
+    }
+
+    return records.size();
+}
+
+uint64_t Sinks::SharedMemoryReader::droppedRecords() const
+{
+    return m_dropped;
+}
+
+bool Sinks::SharedMemoryReader::isWriterAlive() const
+{
+    auto pid = static_cast<pid_t>(m_header->pid);
+
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
@@ -0,0 +1,24 @@
+#include <iostream>
+#include "Sinks/TerminalSink.hpp"
+
+Sinks::TerminalSink::TerminalSink()
+{
+
+}
+
+void Sinks::TerminalSink::onWrite(const AbstractLogger::Message& message, const std::string& formatted)
+{
+    if (message.errorClass <= AbstractLogger::ErrorClass::Info)
+    {
+        std::cout << formatted << '\n';
+    }
+    else
+    {
+        std::cerr << formatted << '\n';
+    }
+}
+
+void Sinks::TerminalSink::onCommit()
+{
+    std::cout.flush();
+}
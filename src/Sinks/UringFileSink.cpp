@@ -0,0 +1,729 @@
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <SystemTools.h>
+#include "Sinks/UringFileSink.hpp"
+
+static constexpr std::size_t NoBuffer = std::numeric_limits<std::size_t>::max();
+static constexpr uint64_t NoOffset = std::numeric_limits<uint64_t>::max();
+static constexpr int MaxWriteRetries = 3;
+
+/**
+ * @brief Class, that describes the way
+ * buffers are written to disk.
+ */
+class Sinks::UringFileSink::Backend
+{
+public:
+    /**
+     * @brief Virtual destructor.
+     */
+    virtual ~Backend() = default;
+
+    /**
+     * @brief Method for submitting write.
+     * @param fd File descriptor.
+     * @param data Pointer to data.
+     * @param size Size of data.
+     * @param offset Offset in file.
+     * @param index Buffer index.
+     * @param registered Is buffer registered.
+     */
+    virtual void submit(int fd,
+                        const char* data,
+                        std::size_t size,
+                        uint64_t offset,
+                        std::size_t index,
+                        bool registered) = 0;
+
+    /**
+     * @brief Method for getting finished writes.
+     * @param wait Wait for at least one write.
+     * @param completed Buffer indices with write results.
+     */
+    virtual void reap(bool wait, std::vector<std::pair<std::size_t, int64_t>>& completed) = 0;
+};
+
+/**
+ * @brief Backend, that submits writes to io_uring.
+ */
+class Sinks::UringFileSink::UringBackend : public Backend
+{
+public:
+    static constexpr unsigned Entries = 64;
+
+    /**
+     * @brief Constructor. Throws std::runtime_error
+     * if io_uring is not available.
+     * @param buffers Buffers, that has to be registered.
+     */
+    explicit UringBackend(const std::vector<iovec>& buffers) :
+        m_fd(-1),
+        m_sqRing(MAP_FAILED),
+        m_cqRing(MAP_FAILED),
+        m_sqes(MAP_FAILED),
+        m_sqRingSize(0),
+        m_cqRingSize(0),
+        m_sqesSize(0),
+        m_sqHead(nullptr),
+        m_sqTail(nullptr),
+        m_sqMask(0),
+        m_sqArray(nullptr),
+        m_cqHead(nullptr),
+        m_cqTail(nullptr),
+        m_cqMask(0),
+        m_cqes(nullptr),
+        m_buffersRegistered(false)
+    {
+        io_uring_params params{};
+
+        m_fd = static_cast<int>(syscall(__NR_io_uring_setup, Entries, &params));
+
+        if (m_fd < 0)
+        {
+            throw std::runtime_error("Can't setup io_uring: " + SystemTools::getLastErrorString());
+        }
+
+        // Plain writes and no dropped completions are required
+        if (!(params.features & IORING_FEAT_NODROP) ||
+            !(params.features & IORING_FEAT_RW_CUR_POS))
+        {
+            release();
+            throw std::runtime_error("io_uring is not supported by kernel.");
+        }
+
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (singleMap)
+        {
+            m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+        }
+
+        m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+
+        if (m_sqRing != MAP_FAILED)
+        {
+            m_cqRing = singleMap ?
+                       m_sqRing :
+                       mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+
+            m_sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        }
+
+        if (m_sqRing == MAP_FAILED || m_cqRing == MAP_FAILED || m_sqes == MAP_FAILED)
+        {
+            auto error = SystemTools::getLastErrorString();
+            release();
+            throw std::runtime_error("Can't map io_uring: " + error);
+        }
+
+        auto sq = static_cast<char*>(m_sqRing);
+        auto cq = static_cast<char*>(m_cqRing);
+
+        m_sqHead  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        m_sqTail  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sqMask  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        m_cqHead  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cqTail  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cqMask  = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // If buffers can't be registered (for example
+        // because of RLIMIT_MEMLOCK), plain writes are used.
+        m_buffersRegistered = !buffers.empty() &&
+            syscall(
+                __NR_io_uring_register,
+                m_fd,
+                IORING_REGISTER_BUFFERS,
+                buffers.data(),
+                static_cast<unsigned>(buffers.size())
+            ) == 0;
+    }
+
+    ~UringBackend() override
+    {
+        release();
+    }
+
+    void submit(int fd,
+                const char* data,
+                std::size_t size,
+                uint64_t offset,
+                std::size_t index,
+                bool registered) override
+    {
+        unsigned tail = *m_sqTail;
+
+        // Queue can be full only if previous submissions failed
+        while (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= Entries)
+        {
+            enter(0, IORING_ENTER_GETEVENTS);
+        }
+
+        unsigned sqIndex = tail & m_sqMask;
+
+        auto& sqe = static_cast<io_uring_sqe*>(m_sqes)[sqIndex];
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = static_cast<uint32_t>(size);
+        sqe.off = offset;
+        sqe.user_data = index;
+
+        if (registered && m_buffersRegistered)
+        {
+            sqe.opcode = IORING_OP_WRITE_FIXED;
+            sqe.buf_index = static_cast<uint16_t>(index);
+        }
+        else
+        {
+            sqe.opcode = IORING_OP_WRITE;
+        }
+
+        m_sqArray[sqIndex] = sqIndex;
+
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        enter(0, 0);
+    }
+
+    void reap(bool wait, std::vector<std::pair<std::size_t, int64_t>>& completed) override
+    {
+        unsigned head = *m_cqHead;
+
+        if (wait && head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE))
+        {
+            enter(1, IORING_ENTER_GETEVENTS);
+        }
+
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head)
+        {
+            auto& cqe = m_cqes[head & m_cqMask];
+
+            completed.emplace_back(static_cast<std::size_t>(cqe.user_data), cqe.res);
+        }
+
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    /**
+     * @brief Method for submitting all queued
+     * entries and waiting for completions.
+     * @param minComplete Number of completions to wait.
+     * @param flags io_uring_enter flags.
+     */
+    void enter(unsigned minComplete, unsigned flags)
+    {
+        auto toSubmit = *m_sqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+
+        while (syscall(__NR_io_uring_enter, m_fd, toSubmit, minComplete, flags, nullptr, 0) < 0 &&
+               errno == EINTR)
+        {}
+    }
+
+    void release()
+    {
+        if (m_sqes != MAP_FAILED)
+        {
+            munmap(m_sqes, m_sqesSize);
+        }
+
+        if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing)
+        {
+            munmap(m_cqRing, m_cqRingSize);
+        }
+
+        if (m_sqRing != MAP_FAILED)
+        {
+            munmap(m_sqRing, m_sqRingSize);
+        }
+
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+
+        m_sqes = m_cqRing = m_sqRing = MAP_FAILED;
+        m_fd = -1;
+    }
+
+    int m_fd;
+
+    void* m_sqRing;
+    void* m_cqRing;
+    void* m_sqes;
+    std::size_t m_sqRingSize;
+    std::size_t m_cqRingSize;
+    std::size_t m_sqesSize;
+
+    unsigned* m_sqHead;
+    unsigned* m_sqTail;
+    unsigned m_sqMask;
+    unsigned* m_sqArray;
+
+    unsigned* m_cqHead;
+    unsigned* m_cqTail;
+    unsigned m_cqMask;
+    io_uring_cqe* m_cqes;
+
+    bool m_buffersRegistered;
+};
+
+/**
+ * @brief Fallback backend, that writes
+ * buffers with `pwrite` from dedicated thread.
+ */
+class Sinks::UringFileSink::ThreadBackend : public Backend
+{
+public:
+    ThreadBackend() :
+        m_working(true),
+        m_tasks(),
+        m_completed(),
+        m_mutex(),
+        m_tasksVariable(),
+        m_completedVariable(),
+        m_thread()
+    {
+        m_thread = std::thread(&ThreadBackend::writingThread, this);
+    }
+
+    ~ThreadBackend() override
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_working = false;
+        }
+
+        m_tasksVariable.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void submit(int fd,
+                const char* data,
+                std::size_t size,
+                uint64_t offset,
+                std::size_t index,
+                bool) override
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_tasks.push_back({fd, data, size, offset, index});
+        }
+
+        m_tasksVariable.notify_one();
+    }
+
+    void reap(bool wait, std::vector<std::pair<std::size_t, int64_t>>& completed) override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (wait && m_completed.empty())
+        {
+            m_completedVariable.wait(lock);
+        }
+
+        completed.insert(completed.end(), m_completed.begin(), m_completed.end());
+        m_completed.clear();
+    }
+
+private:
+    struct Task
+    {
+        int fd;
+        const char* data;
+        std::size_t size;
+        uint64_t offset;
+        std::size_t index;
+    };
+
+    void writingThread()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true)
+        {
+            while (m_tasks.empty() && m_working)
+            {
+                m_tasksVariable.wait(lock);
+            }
+
+            if (m_tasks.empty())
+            {
+                break;
+            }
+
+            auto task = m_tasks.front();
+            m_tasks.pop_front();
+
+            lock.unlock();
+
+            int64_t result;
+            do
+            {
+                result = pwrite(task.fd, task.data, task.size, static_cast<off_t>(task.offset));
+            } while (result < 0 && errno == EINTR);
+
+            if (result < 0)
+            {
+                result = -errno;
+            }
+
+            lock.lock();
+
+            m_completed.emplace_back(task.index, result);
+            m_completedVariable.notify_one();
+        }
+    }
+
+    bool m_working;
+    std::deque<Task> m_tasks;
+    std::vector<std::pair<std::size_t, int64_t>> m_completed;
+    std::mutex m_mutex;
+    std::condition_variable m_tasksVariable;
+    std::condition_variable m_completedVariable;
+    std::thread m_thread;
+};
+
+Sinks::UringFileSink::UringFileSink(std::size_t bufferSize, std::size_t buffersCount) :
+    m_backend(),
+    m_buffers(),
+    m_freeBuffers(),
+    m_completed(),
+    m_bufferSize(bufferSize),
+    m_currentBuffer(NoBuffer),
+    m_inFlight(0),
+    m_pendingBytes(0),
+    m_maxPendingBytes(64 * 1024 * 1024),
+    m_fd(-1),
+    m_offset(0),
+    m_failedOffset(NoOffset),
+    m_hasFailedWrites(false),
+    m_failedWrites(0)
+{
+    std::vector<iovec> registered;
+
+    for (std::size_t i = 0; i < buffersCount; ++i)
+    {
+        m_buffers.push_back({std::unique_ptr<char[]>(new char[bufferSize]), bufferSize, 0, 0, 0, 0, true, false});
+        registered.push_back({m_buffers.back().data.get(), bufferSize});
+
+        m_freeBuffers.push_back(buffersCount - i - 1);
+    }
+
+    try
+    {
+        m_backend = std::make_unique<UringBackend>(registered);
+    }
+    catch (std::runtime_error&)
+    {
+        m_backend = std::make_unique<ThreadBackend>();
+    }
+}
+
+Sinks::UringFileSink::~UringFileSink()
+{
+    closeFile();
+}
+
+bool Sinks::UringFileSink::isUringUsed() const
+{
+    return dynamic_cast<UringBackend*>(m_backend.get()) != nullptr;
+}
+
+void Sinks::UringFileSink::setMaximumPendingBytes(uint64_t bytes)
+{
+    m_maxPendingBytes = bytes;
+}
+
+uint64_t Sinks::UringFileSink::maximumPendingBytes() const
+{
+    return m_maxPendingBytes;
+}
+
+uint64_t Sinks::UringFileSink::failedWrites() const
+{
+    return m_failedWrites;
+}
+
+int64_t Sinks::UringFileSink::openFile(const std::string& path)
+{
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+    if (m_fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat fileStat{};
+
+    if (fstat(m_fd, &fileStat) != 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        return -1;
+    }
+
+    m_offset = static_cast<uint64_t>(fileStat.st_size);
+
+    return static_cast<int64_t>(m_offset);
+}
+
+void Sinks::UringFileSink::closeFile()
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+
+    submitCurrent();
+
+    // File can't be closed with pending writes
+    while (m_inFlight > 0)
+    {
+        reap(true);
+    }
+
+    truncateFailed();
+
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool Sinks::UringFileSink::isFileOpened() const
+{
+    return m_fd >= 0;
+}
+
+void Sinks::UringFileSink::writeLine(const std::string& formatted)
+{
+    auto size = formatted.size() + 1;
+
+    if (m_currentBuffer != NoBuffer &&
+        m_buffers[m_currentBuffer].capacity - m_buffers[m_currentBuffer].used < size)
+    {
+        submitCurrent();
+    }
+
+    if (m_currentBuffer == NoBuffer)
+    {
+        m_currentBuffer = acquireBuffer(size);
+    }
+
+    auto& buffer = m_buffers[m_currentBuffer];
+
+    std::memcpy(buffer.data.get() + buffer.used, formatted.data(), formatted.size());
+    buffer.data[buffer.used + formatted.size()] = '\n';
+
+    buffer.used += size;
+}
+
+void Sinks::UringFileSink::flushFile()
+{
+    submitCurrent();
+
+    reap(false);
+}
+
+bool Sinks::UringFileSink::syncFile()
+{
+    submitCurrent();
+
+    while (m_inFlight > 0)
+    {
+        reap(true);
+    }
+
+    truncateFailed();
+
+    auto synced = fdatasync(m_fd) == 0 && !m_hasFailedWrites;
+
+    m_hasFailedWrites = false;
+
+    return synced;
+}
+
+std::size_t Sinks::UringFileSink::acquireBuffer(std::size_t bytes)
+{
+    reap(false);
+
+    while (true)
+    {
+        for (auto iterator = m_freeBuffers.rbegin(); iterator != m_freeBuffers.rend(); ++iterator)
+        {
+            auto index = *iterator;
+
+            if (m_buffers[index].capacity >= bytes)
+            {
+                m_freeBuffers.erase(std::next(iterator).base());
+                return index;
+            }
+        }
+
+        // Disk is stalled, allocating additional buffer
+        if (m_pendingBytes < m_maxPendingBytes || m_inFlight == 0)
+        {
+            auto capacity = std::max(bytes, m_bufferSize);
+
+            m_buffers.push_back({std::unique_ptr<char[]>(new char[capacity]), capacity, 0, 0, 0, 0, false, false});
+
+            return m_buffers.size() - 1;
+        }
+
+        reap(true);
+    }
+}
+
+void Sinks::UringFileSink::submitCurrent()
+{
+    if (m_currentBuffer == NoBuffer)
+    {
+        return;
+    }
+
+    auto index = m_currentBuffer;
+    auto& buffer = m_buffers[index];
+
+    m_currentBuffer = NoBuffer;
+
+    if (buffer.used == 0)
+    {
+        m_freeBuffers.push_back(index);
+        return;
+    }
+
+    // Buffer can't be placed after hole,
+    // so file is truncated at first
+    if (m_failedOffset != NoOffset)
+    {
+        while (m_inFlight > 0)
+        {
+            reap(true);
+        }
+
+        truncateFailed();
+    }
+
+    buffer.offset = m_offset;
+    buffer.written = 0;
+    buffer.retries = 0;
+    buffer.inFlight = true;
+
+    m_offset += buffer.used;
+    m_pendingBytes += buffer.capacity;
+    ++m_inFlight;
+
+    submit(index);
+}
+
+void Sinks::UringFileSink::submit(std::size_t index)
+{
+    auto& buffer = m_buffers[index];
+
+    m_backend->submit(
+        m_fd,
+        buffer.data.get() + buffer.written,
+        buffer.used - buffer.written,
+        buffer.offset + buffer.written,
+        index,
+        buffer.registered
+    );
+}
+
+void Sinks::UringFileSink::reap(bool wait)
+{
+    m_completed.clear();
+
+    m_backend->reap(wait, m_completed);
+
+    for (auto&& [index, result] : m_completed)
+    {
+        auto& buffer = m_buffers[index];
+
+        if (result == -EINTR || result == -EAGAIN)
+        {
+            submit(index);
+            continue;
+        }
+
+        // Short write
+        if (result > 0)
+        {
+            buffer.written += static_cast<std::size_t>(result);
+
+            if (buffer.written < buffer.used)
+            {
+                submit(index);
+                continue;
+            }
+        }
+        else if (buffer.retries < MaxWriteRetries)
+        {
+            ++buffer.retries;
+
+            submit(index);
+            continue;
+        }
+        else
+        {
+            // Rest of buffer is lost, file is truncated
+            // at it's offset to prevent hole
+            m_failedOffset = std::min(m_failedOffset, buffer.offset + buffer.written);
+            m_hasFailedWrites = true;
+
+            ++m_failedWrites;
+        }
+
+        // Buffer is written or error acquired
+        m_pendingBytes -= buffer.capacity;
+        --m_inFlight;
+
+        buffer.inFlight = false;
+        buffer.used = 0;
+        buffer.written = 0;
+
+        m_freeBuffers.push_back(index);
+    }
+}
+
+void Sinks::UringFileSink::truncateFailed()
+{
+    if (m_failedOffset == NoOffset)
+    {
+        return;
+    }
+
+    if (ftruncate(m_fd, static_cast<off_t>(m_failedOffset)) == 0)
+    {
+        m_offset = m_failedOffset;
+    }
+
+    m_failedOffset = NoOffset;
+}
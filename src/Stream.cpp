@@ -1,4 +1,5 @@
 #include "Stream.hpp"
+#include "FlightRecorder.hpp"
 
 Loggers::StreamBuffer::StreamBuffer() :
     m_ss(),
@@ -8,46 +9,91 @@ Loggers::StreamBuffer::StreamBuffer() :
     m_line(0),
     m_thread(),
     m_classname(),
-    m_function(nullptr)
+    m_function(nullptr),
+    m_action(Logger::CallSite::Action::Skip),
+    m_fields(),
+    m_timestamp(0)
 {
 
 }
 
-void Loggers::StreamBuffer::newMessage(LoggerPtr logger,
+void Loggers::StreamBuffer::newMessage(AbstractLogger* logger,
                                       AbstractLogger::ErrorClass errorClass,
                                       const char *filename,
                                       int line,
                                       std::thread::id thread,
                                       std::string classname,
-                                      const char *function)
+                                      const char *function,
+                                      Logger::CallSite::Action action)
 {
-    m_logger = std::move(logger);
+    m_logger = logger;
     m_errorClass = errorClass;
     m_filename = filename;
     m_line = line;
     m_thread = thread;
     m_classname = std::move(classname);
     m_function = function;
+    m_action = action;
+    m_fields.clear();
+
+    // Time of call, not of stream destruction
+    m_timestamp = m_logger ? Logger::Clock::now() : 0;
+}
+
+void Loggers::StreamBuffer::addField(Logger::Field field)
+{
+    // Fields of skipped messages are not stored
+    if (m_logger)
+    {
+        m_fields.push_back(std::move(field));
+    }
 }
 
 void Loggers::StreamBuffer::postMessage()
 {
+    if (m_action == Logger::CallSite::Action::Record)
+    {
+        m_logger = nullptr;
+
+        Logger::FlightRecorder::record(
+            m_errorClass,
+            m_filename,
+            m_line,
+            m_thread,
+            m_classname,
+            m_function,
+            m_ss
+        );
+
+        m_ss.clear();
+        return;
+    }
+
     if (!m_logger)
     {
+        m_ss.clear();
         return;
     }
 
-    m_logger->log(
+    // Message can be logged from `log`, so
+    // buffer is released before
+    auto logger = m_logger;
+    m_logger = nullptr;
+
+    logger->log(
         m_errorClass,
         m_filename,
         m_line,
         m_thread,
         std::move(m_classname),
         m_function,
-        m_ss
+        m_ss,
+        std::move(m_fields),
+        m_timestamp
     );
 
     m_ss.clear();
+    m_fields.clear();
 }
 
 int Loggers::StreamBuffer::overflow(int __c)
@@ -59,26 +105,50 @@ int Loggers::StreamBuffer::overflow(int __c)
 
 static thread_local Loggers::StreamBuffer streamBuffer;
 
-Loggers::Stream::Stream(LoggerPtr logger,
+thread_local Logger::CallSite::Action Loggers::StreamGate::m_action = Logger::CallSite::Action::Skip;
+thread_local std::string_view Loggers::StreamGate::m_classname;
+
+Loggers::Stream::Stream(AbstractLogger* logger,
                        AbstractLogger::ErrorClass errorClass,
                        const char *filename,
                        int line,
                        std::thread::id thread,
                        std::string classname,
-                       const char *function) :
-    std::ostream(&streamBuffer)
+                       const char *function,
+                       Logger::CallSite::Action action) :
+    std::ostream(&streamBuffer),
+    m_owner()
 {
+    if (action == Logger::CallSite::Action::Skip)
+    {
+        logger = nullptr;
+    }
+
     streamBuffer.newMessage(
-        std::move(logger),
+        logger,
         errorClass,
         filename,
         line,
         thread,
         std::move(classname),
-        function
+        function,
+        action
     );
 }
 
+Loggers::Stream::Stream(LoggerPtr logger,
+                       AbstractLogger::ErrorClass errorClass,
+                       const char *filename,
+                       int line,
+                       std::thread::id thread,
+                       std::string classname,
+                       const char *function,
+                       Logger::CallSite::Action action) :
+    Stream(logger.get(), errorClass, filename, line, thread, std::move(classname), function, action)
+{
+    m_owner = std::move(logger);
+}
+
 Loggers::Stream::~Stream()
 {
     streamBuffer.postMessage();
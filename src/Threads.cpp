@@ -0,0 +1,135 @@
+#include <atomic>
+#include <sstream>
+#include <unordered_map>
+#include "Threads.hpp"
+#include "Epoch.hpp"
+
+namespace
+{
+    using Names = std::unordered_map<std::thread::id, std::string>;
+
+    // Changed on every name change, so
+    // rendering caches are dropped
+    std::atomic<uint64_t> g_generation(1);
+
+    // Threads can be created and finished without
+    // logging, so cache is limited
+    constexpr std::size_t MaximumCacheSize = 1024;
+
+    Epoch::Atomic<Names>& names()
+    {
+        // Created on first use, threads can be
+        // named from static initialization
+        static Epoch::Atomic<Names> names;
+
+        return names;
+    }
+
+    void changeName(std::thread::id thread, std::string name)
+    {
+        names().update(
+            [thread, &name](Names& value)
+            {
+                if (name.empty())
+                {
+                    value.erase(thread);
+                }
+                else
+                {
+                    value[thread] = std::move(name);
+                }
+            }
+        );
+
+        ++g_generation;
+    }
+
+    /**
+     * @brief Struct, that removes name of
+     * finished thread, because thread id
+     * can be reused by new thread.
+     */
+    struct NameGuard
+    {
+        ~NameGuard()
+        {
+            if (named)
+            {
+                changeName(std::this_thread::get_id(), std::string());
+            }
+        }
+
+        bool named = false;
+    };
+
+    struct RenderCache
+    {
+        uint64_t generation = 0;
+        std::unordered_map<std::thread::id, Logger::Threads::Rendered> entries;
+    };
+}
+
+void Logger::Threads::setName(std::string name)
+{
+    bool named = !name.empty();
+
+    changeName(std::this_thread::get_id(), std::move(name));
+
+    // Guard is created after epoch state of thread,
+    // so it's destroyed before it
+    static thread_local NameGuard guard;
+
+    guard.named = named;
+}
+
+std::string Logger::Threads::name(std::thread::id thread)
+{
+    Epoch::ReadGuard guard;
+
+    auto value = names().load();
+    auto finded = value->find(thread);
+
+    if (finded == value->end())
+    {
+        return std::string();
+    }
+
+    return finded->second;
+}
+
+const Logger::Threads::Rendered& Logger::Threads::render(std::thread::id thread)
+{
+    static thread_local RenderCache cache;
+
+    auto generation = g_generation.load(std::memory_order_acquire);
+
+    if (cache.generation != generation || cache.entries.size() >= MaximumCacheSize)
+    {
+        cache.entries.clear();
+        cache.generation = generation;
+    }
+
+    auto finded = cache.entries.find(thread);
+
+    if (finded != cache.entries.end())
+    {
+        return finded->second;
+    }
+
+    std::ostringstream ss;
+    ss << "0x";
+    ss.fill('0');
+    ss.width(16);
+    ss << std::hex << thread;
+
+    Rendered rendered;
+    rendered.id = ss.str();
+    rendered.name = name(thread);
+
+    if (rendered.name.empty())
+    {
+        rendered.name = rendered.id;
+    }
+
+    return cache.entries.emplace(thread, std::move(rendered)).first->second;
+}
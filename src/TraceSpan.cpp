@@ -0,0 +1,89 @@
+#include <sstream>
+#include "TraceSpan.hpp"
+#include "CurrentLogger.hpp"
+#include "Clock.hpp"
+
+std::atomic_bool Logger::TraceSpan::m_enabled(false);
+
+void Logger::TraceSpan::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+Logger::TraceSpan::TraceSpan(const char* filename,
+                             int line,
+                             const char* function,
+                             const char* name,
+                             std::chrono::milliseconds threshold) :
+    m_filename(filename),
+    m_line(line),
+    m_function(function),
+    m_name(name),
+    m_threshold(threshold),
+    m_begin(0)
+{
+    if (isEnabled() || m_threshold.count() > 0)
+    {
+        m_begin = Clock::now();
+    }
+}
+
+Logger::TraceSpan::~TraceSpan()
+{
+    if (m_begin == 0)
+    {
+        return;
+    }
+
+    auto end = Clock::now();
+
+    // Raw values can be taken by different sources
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::toTimePoint(end) - Clock::toTimePoint(m_begin)
+    );
+
+    if (elapsed.count() < 0)
+    {
+        elapsed = std::chrono::nanoseconds(0);
+    }
+
+    CurrentLogger::Reference reference;
+
+    auto logger = reference.get();
+
+    if (logger == nullptr)
+    {
+        return;
+    }
+
+    if (isEnabled())
+    {
+        logger->logSpan(
+            m_filename,
+            m_line,
+            std::this_thread::get_id(),
+            m_function,
+            m_name,
+            m_begin,
+            static_cast<uint64_t>(elapsed.count())
+        );
+    }
+
+    if (m_threshold.count() > 0 && elapsed > m_threshold)
+    {
+        std::ostringstream ss;
+        ss << "Span \"" << m_name << "\" took "
+           << std::chrono::duration<double, std::milli>(elapsed).count() << " ms, threshold "
+           << m_threshold.count() << " ms";
+
+        logger->log(
+            AbstractLogger::ErrorClass::Warning,
+            m_filename,
+            m_line,
+            std::this_thread::get_id(),
+            std::string(),
+            m_function,
+            ss.str()
+        );
+    }
+}
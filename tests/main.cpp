@@ -1,18 +1,2037 @@
 
 #include <Loggers/BasicLogger.hpp>
+#include <Loggers/AsyncLogger.hpp>
+#include <Loggers/StaticLogger.hpp>
 #include <Stream.hpp>
+#include <CurrentLogger.hpp>
+#include <SystemTools.h>
+#include <Sinks/AbstractSink.hpp>
+#include <Formatters/PatternFormatter.hpp>
+#include <Formatters/JsonLinesFormatter.hpp>
+#include <Formatters/Sanitizer.hpp>
+#include <Sinks/MappedFileSink.hpp>
+#include <Sinks/UringFileSink.hpp>
+#include <Sinks/SharedMemorySink.hpp>
+#include <Sinks/AppendFileSink.hpp>
+#include <Sinks/AsyncSink.hpp>
+#include <Sinks/CollectorSink.hpp>
+#include <Collector.hpp>
+#include <LogsListener.hpp>
+#include <BatchLogsListener.hpp>
+#include <FlightRecorder.hpp>
+#include <Threads.hpp>
+#include <Backtrace.hpp>
+#include <TraceSpan.hpp>
+#include <Sinks/ChromeTraceSink.hpp>
+#include <RecordQueue.hpp>
+#include <filesystem>
+#include <sstream>
+#include <future>
+#include <iomanip>
+#include <random>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
 #include "gtest/gtest.h"
-#define DebugF(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define InfoF(L)     Loggers::Stream(L, AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define WarningF(L)  Loggers::Stream(L, AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
-#define ErrorF(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define DebugL(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Debug,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define InfoL(L)     Loggers::Stream(L, AbstractLogger::ErrorClass::Info,    __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define WarningL(L)  Loggers::Stream(L, AbstractLogger::ErrorClass::Warning, __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
+#define ErrorL(L)    Loggers::Stream(L, AbstractLogger::ErrorClass::Error,   __FILENAME__, __LINE__, std::this_thread::get_id(), std::string(), __FUNCTION__)
 
 
 TEST(ALogger, Basic)
 {
     auto logger = std::make_shared<Loggers::BasicLogger>();
 
-    InfoF(logger) << "Example output";
+    InfoL(logger) << "Example output";
+}
+
+TEST(ALogger, AsyncParallelFormattingKeepsOrder)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_parallel_formatting";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    {
+        auto logger = std::make_shared<Loggers::AsyncLogger>(4);
+
+        logger->setLogPath(path.string());
+        logger->setFormat("%{MESSAGE}");
+        logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            InfoL(logger) << i;
+        }
+
+        logger->waitForLogToBeWritten();
+    }
+
+    std::stringstream ss(SystemTools::getFileContent((path / "log.txt").string()));
+
+    int expected = 0;
+    int value;
+    while (ss >> value)
+    {
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+
+    ASSERT_EQ(expected, 10000);
+
+    std::filesystem::remove_all(path);
+}
+
+class MemorySink : public Sinks::AbstractSink
+{
+public:
+    std::vector<std::string> lines;
+
+    // Lines can be written from other thread
+    std::atomic<std::size_t> written{0};
+
+    bool waitForLines(std::size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (written.load() < count)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return true;
+    }
+
+protected:
+    void onWrite(const AbstractLogger::Message&, const std::string& formatted) override
+    {
+        lines.push_back(formatted);
+        ++written;
+    }
+};
+
+class CountingFormatter : public Formatters::PatternFormatter
+{
+public:
+    CountingFormatter() :
+        Formatters::PatternFormatter("%{ERROR_CLASS}: %{MESSAGE}")
+    {}
+
+    std::string format(const AbstractLogger::Message& message) const override
+    {
+        ++calls;
+        return PatternFormatter::format(message);
+    }
+
+    mutable int calls = 0;
+};
+
+TEST(ALogger, SinksLevelsAndSharedFormatting)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto formatter = std::make_shared<CountingFormatter>();
+
+    auto debugSink = std::make_shared<MemorySink>();
+    debugSink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+    debugSink->setFormatter(formatter);
+
+    auto errorSink = std::make_shared<MemorySink>();
+    errorSink->setMinimumErrorClass(AbstractLogger::ErrorClass::Error);
+    errorSink->setFormatter(formatter);
+
+    auto ownFormatSink = std::make_shared<MemorySink>();
+    ownFormatSink->setFormat("%{MESSAGE}");
+
+    logger->addSink(debugSink);
+    logger->addSink(errorSink);
+    logger->addSink(ownFormatSink);
+
+    DebugL(logger) << "first";
+    ErrorL(logger) << "second";
+
+    ASSERT_EQ(debugSink->lines, std::vector<std::string>({"Debug: first", "Error: second"}));
+    ASSERT_EQ(errorSink->lines, std::vector<std::string>({"Error: second"}));
+    ASSERT_EQ(ownFormatSink->lines, std::vector<std::string>({"second"}));
+    ASSERT_EQ(formatter->calls, 2);
+}
+
+static void checkFileSinkRotation(std::shared_ptr<Sinks::FileSink> sink, const std::string& name)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    {
+        auto logger = std::make_shared<Loggers::BasicLogger>();
+
+        logger->setFileSink(std::move(sink));
+        logger->setLogPath(path.string());
+        logger->setMaximumLogFile(1000);
+        logger->setFormat("%{MESSAGE}");
+        logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            InfoL(logger) << "line " << i;
+        }
+    }
+
+    std::string content;
+    int rotated = 0;
+    while (std::filesystem::exists(path / ("log.txt_" + std::to_string(rotated + 1))))
+    {
+        ++rotated;
+        content += SystemTools::getFileContent((path / ("log.txt_" + std::to_string(rotated))).string());
+    }
+
+    content += SystemTools::getFileContent((path / "log.txt").string());
+
+    ASSERT_GE(rotated, 1);
+
+    std::string expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        expected += "line " + std::to_string(i) + "\n";
+    }
+
+    ASSERT_EQ(content, expected);
+
+    std::filesystem::remove_all(path);
+}
+
+TEST(ALogger, MappedFileSinkRotation)
+{
+    checkFileSinkRotation(std::make_shared<Sinks::MappedFileSink>(), "alogger_mapped_file");
+}
+
+TEST(ALogger, UringFileSinkRotation)
+{
+    // Small buffers to check buffers switching
+    checkFileSinkRotation(std::make_shared<Sinks::UringFileSink>(64, 2), "alogger_uring_file");
+}
+
+TEST(ALogger, UringFileSinkTruncatesFailedWrites)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_uring_failure";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto sink = std::make_shared<Sinks::UringFileSink>(64, 2);
+    sink->setLogPath(path.string());
+    sink->setFormatter(std::make_shared<Formatters::PatternFormatter>("%{MESSAGE}"));
+    logger->addSink(sink);
+
+    // Writes after file size limit fail with EFBIG
+    rlimit previous{};
+    getrlimit(RLIMIT_FSIZE, &previous);
+
+    auto previousHandler = signal(SIGXFSZ, SIG_IGN);
+
+    rlimit limit = previous;
+    limit.rlim_cur = 1000;
+    setrlimit(RLIMIT_FSIZE, &limit);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        InfoL(logger) << "line " << std::setw(10) << i;
+    }
+
+    auto durable = logger->waitForLogToBeDurable();
+
+    setrlimit(RLIMIT_FSIZE, &previous);
+    signal(SIGXFSZ, previousHandler);
+
+    ASSERT_FALSE(durable);
+    ASSERT_GT(sink->failedWrites(), 0);
+
+    // File has only complete writes without holes
+    auto content = SystemTools::getFileContent((path / "log.txt").string());
+
+    ASSERT_LE(content.size(), 1000);
+    ASSERT_EQ(content.find('\0'), std::string::npos);
+
+    // Writing continues after limit is removed
+    InfoL(logger) << "after";
+
+    ASSERT_TRUE(logger->waitForLogToBeDurable());
+
+    content = SystemTools::getFileContent((path / "log.txt").string());
+
+    ASSERT_EQ(content.find('\0'), std::string::npos);
+    ASSERT_EQ(content.rfind("after\n"), content.size() - 6);
+
+    logger.reset();
+    sink.reset();
+    std::filesystem::remove_all(path);
+}
+
+TEST(ALogger, GroupCommitDurability)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_group_commit";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    auto logger = std::make_shared<Loggers::AsyncLogger>();
+
+    logger->setLogPath(path.string());
+    logger->setFormat("%{MESSAGE}");
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->fileSink()->setDurability(Sinks::FileSink::Durability::GroupCommit);
+
+    InfoL(logger) << "info";
+    ErrorL(logger) << "error";
+
+    ASSERT_TRUE(logger->waitForLogToBeDurable());
+
+    ASSERT_EQ(SystemTools::getFileContent((path / "log.txt").string()), "info\nerror\n");
+
+    logger.reset();
+    std::filesystem::remove_all(path);
+}
+
+class SyncCountingFileSink : public Sinks::FileSink
+{
+public:
+    std::atomic<int> syncs{0};
+
+protected:
+    bool syncFile() override
+    {
+        ++syncs;
+
+        return Sinks::FileSink::syncFile();
+    }
+};
+
+TEST(ALogger, PeriodicDurabilitySyncsIdleFile)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_periodic_sync";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto sink = std::make_shared<SyncCountingFileSink>();
+    sink->setLogPath(path.string());
+    sink->setDurability(Sinks::FileSink::Durability::Periodic);
+    sink->setSyncInterval(std::chrono::milliseconds(50));
+    logger->addSink(sink);
+
+    // First batch is synced at once, second one waits for interval
+    InfoL(logger) << "first";
+    InfoL(logger) << "second";
+
+    ASSERT_EQ(sink->syncs.load(), 1);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    while (sink->syncs.load() < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(sink->syncs.load(), 2);
+
+    logger.reset();
+    sink.reset();
+    std::filesystem::remove_all(path);
+}
+
+class FailingSyncFileSink : public Sinks::FileSink
+{
+protected:
+    bool syncFile() override
+    {
+        return false;
+    }
+};
+
+TEST(ALogger, SyncFailureIsReported)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_sync_failure";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setLogPath(path.string());
+
+    auto sink = std::make_shared<FailingSyncFileSink>();
+    sink->setLogPath((path / "failing").string());
+    logger->addSink(sink);
+
+    std::filesystem::create_directories(path / "failing");
+
+    InfoL(logger) << "info";
+
+    // Renamed file is still synced by it's descriptor
+    std::filesystem::rename(path / "log.txt", path / "renamed.txt");
+
+    ASSERT_FALSE(logger->waitForLogToBeDurable());
+
+    logger->removeSink(sink);
+
+    ASSERT_TRUE(logger->waitForLogToBeDurable());
+
+    logger.reset();
+    std::filesystem::remove_all(path);
+}
+
+class SlowListener : public Logger::LogsListener
+{
+public:
+    AbstractLogger::Message popMessage() override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto message = messages.front();
+        messages.erase(messages.begin());
+        return message;
+    }
+
+    bool hasMessages() const override
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return !messages.empty();
+    }
+
+    void newMessage(const AbstractLogger::Message& m) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        std::unique_lock<std::mutex> lock(mutex);
+        messages.push_back(m);
+    }
+
+    std::size_t count() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return messages.size();
+    }
+
+    mutable std::mutex mutex;
+    std::vector<AbstractLogger::Message> messages;
+};
+
+TEST(ALogger, ListenersAreFedAsynchronously)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto listener = std::make_shared<SlowListener>();
+    logger->addLogsListener(listener);
+
+    // Listeners are added and removed while logging
+    std::thread churn([logger]()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            auto temporary = std::make_shared<SlowListener>();
+            logger->addLogsListener(temporary);
+            logger->removeLogsListener(temporary);
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        InfoL(logger) << i;
+    }
+
+    // Logging thread does not wait for slow listener
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+
+    churn.join();
+
+    for (int i = 0; i < 1000 && listener->count() < 100; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    ASSERT_EQ(listener->count(), 100);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(listener->popMessage().message, std::to_string(i));
+    }
+
+    ASSERT_FALSE(listener->hasMessages());
+}
+
+TEST(ALogger, BatchListenerBorrowsMessages)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto listener = std::make_shared<Logger::BatchLogsListener>();
+    logger->addLogsListener(listener);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        InfoL(logger) << i;
+    }
+
+    Logger::MessagesBatch batch;
+
+    ASSERT_TRUE(listener->borrowMessages(batch, 4));
+    ASSERT_EQ(batch.size(), 4);
+
+    auto first = batch[0].message.data();
+
+    // Not released messages are borrowed again in place
+    ASSERT_TRUE(listener->borrowMessages(batch, 4));
+    ASSERT_EQ(batch[0].message.data(), first);
+
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        ASSERT_EQ(batch[i].message, std::to_string(i));
+    }
+
+    listener->releaseMessages(batch);
+
+    ASSERT_TRUE(listener->borrowMessages(batch));
+    ASSERT_EQ(batch.size(), 6);
+    ASSERT_EQ(batch[0].message, "4");
+    listener->releaseMessages(batch);
+
+    ASSERT_FALSE(listener->hasMessages());
+    ASSERT_EQ(listener->droppedMessages(), 0);
+}
+
+TEST(ALogger, BatchListenerPopsOnlyPublishedMessages)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto listener = std::make_shared<Logger::BatchLogsListener>();
+    logger->addLogsListener(listener);
+
+    std::atomic_bool working(true);
+    std::vector<std::thread> producers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        producers.emplace_back([logger]()
+        {
+            for (int j = 0; j < 5000; ++j)
+            {
+                InfoL(logger) << j;
+            }
+        });
+    }
+
+    // Message is claimed before it's published,
+    // `hasMessages` has to wait for publishing
+    std::size_t failures = 0;
+
+    std::thread consumer([&listener, &working, &failures]()
+    {
+        while (working)
+        {
+            try
+            {
+                if (listener->hasMessages())
+                {
+                    listener->popMessage();
+                }
+            }
+            catch (std::runtime_error&)
+            {
+                ++failures;
+            }
+        }
+    });
+
+    for (auto&& producer : producers)
+    {
+        producer.join();
+    }
+
+    working = false;
+    consumer.join();
+
+    ASSERT_EQ(failures, 0);
+}
+
+TEST(ALogger, MessagesRingReusesSlots)
+{
+    Logger::MessagesRing ring(2);
+
+    AbstractLogger::Message message;
+    message.message = "first";
+
+    ring.push(message);
+
+    uint64_t cursor = 0;
+    uint64_t dropped = 0;
+    Logger::MessagesRing::MessagePtr record;
+
+    ASSERT_TRUE(ring.read(cursor, record, dropped));
+
+    auto address = record.get();
+    record.reset();
+
+    // Released slot object is overwritten in place
+    message.message = "second";
+    ring.push(message);
+    message.message = "third";
+    ring.push(message);
+
+    ASSERT_TRUE(ring.read(cursor, record, dropped));
+    ASSERT_TRUE(ring.read(cursor, record, dropped));
+    ASSERT_EQ(record.get(), address);
+    ASSERT_EQ(record->message, "third");
+
+    // Borrowed slot object is kept unchanged
+    message.message = "fourth";
+    ring.push(message);
+    message.message = "fifth";
+    ring.push(message);
+
+    ASSERT_EQ(record->message, "third");
+
+    ASSERT_TRUE(ring.read(cursor, record, dropped));
+    ASSERT_TRUE(ring.read(cursor, record, dropped));
+    ASSERT_NE(record.get(), address);
+    ASSERT_EQ(record->message, "fifth");
+    ASSERT_EQ(dropped, 0);
+}
+
+TEST(ALogger, ReconfigurationWhileLogging)
+{
+    auto logger = std::make_shared<Loggers::AsyncLogger>(2);
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    std::atomic_bool working(true);
+
+    std::thread configurator([logger, &working]()
+    {
+        auto temporary = std::make_shared<MemorySink>();
+
+        for (int i = 0; working; ++i)
+        {
+            logger->setFormat(i % 2 ? "%{MESSAGE}" : "%{ERROR_CLASS}: %{MESSAGE}");
+            logger->addSink(temporary);
+            logger->removeSink(temporary);
+        }
+    });
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        InfoL(logger) << i;
+    }
+
+    logger->waitForLogToBeWritten();
+
+    working = false;
+    configurator.join();
+
+    ASSERT_EQ(sink->lines.size(), 10000);
+}
+
+class StalledSink : public Sinks::AbstractSink
+{
+public:
+    std::atomic_bool stalled{true};
+    std::atomic<std::size_t> written{0};
+
+protected:
+    void onWrite(const AbstractLogger::Message&, const std::string&) override
+    {
+        while (stalled)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        ++written;
+    }
+};
+
+TEST(ALogger, FormattingThreadsKeepQueueBounded)
+{
+    auto logger = std::make_shared<Loggers::AsyncLogger>(2, 64);
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto sink = std::make_shared<StalledSink>();
+    logger->addSink(sink);
+
+    std::atomic<std::size_t> pushed(0);
+
+    std::thread producer([logger, &pushed]()
+    {
+        for (int i = 0; i < 20000; ++i)
+        {
+            InfoL(logger) << i;
+            ++pushed;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // Queue, batches of formatting threads, waiting
+    // batches and batches of writer are bounded
+    EXPECT_LT(pushed.load(), 2000);
+
+    sink->stalled = false;
+    producer.join();
+
+    logger->waitForLogToBeWritten();
+
+    ASSERT_EQ(sink->written.load(), 20000);
+}
+
+namespace Network
+{
+    class Socket
+    {
+    public:
+        void read()
+        {
+            Debug() << "socket";
+        }
+    };
+}
+
+namespace Storage
+{
+    class Disk
+    {
+    public:
+        void read()
+        {
+            Debug() << "disk";
+            Warning() << "disk";
+        }
+    };
+}
+
+TEST(ALogger, CategoryLevels)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+    logger->addSink(sink);
+
+    CurrentLogger::setCurrentLogger(logger);
+
+    Network::Socket socket;
+    Storage::Disk disk;
+
+    socket.read();
+    disk.read();
+
+    Logger::Categories::setDefaultLevel(AbstractLogger::ErrorClass::Info);
+    Logger::Categories::setLevel("Network::*", AbstractLogger::ErrorClass::Debug);
+
+    socket.read();
+    disk.read();
+
+    ASSERT_EQ(Logger::Categories::level("Network::Socket"), AbstractLogger::ErrorClass::Debug);
+    ASSERT_EQ(Logger::Categories::level("Storage::Disk"), AbstractLogger::ErrorClass::Info);
+
+    Logger::Categories::resetLevel("Network");
+    Logger::Categories::resetLevel("");
+
+    socket.read();
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"socket", "disk", "disk", "socket", "disk", "socket"}));
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+namespace Storage
+{
+    class Device
+    {
+    public:
+        virtual ~Device() = default;
+
+        void open()
+        {
+            Warning() << "open";
+        }
+    };
+
+    class Ssd : public Device
+    {};
+}
+
+TEST(ALogger, ClassContextIsStaticType)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{CONTEXT}: %{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    CurrentLogger::setCurrentLogger(logger);
+
+    // Category and context of base class method are same
+    Logger::Categories::setLevel("Storage::Ssd", AbstractLogger::ErrorClass::None);
+
+    Storage::Ssd ssd;
+    ssd.open();
+    ssd.open();
+
+    Logger::Categories::resetLevel("Storage::Ssd");
+    Logger::Categories::setLevel("Storage::Device", AbstractLogger::ErrorClass::None);
+
+    ssd.open();
+
+    Logger::Categories::resetLevel("Storage::Device");
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"Storage::Device::open: open", "Storage::Device::open: open"}));
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+namespace Flood
+{
+    class Loop
+    {
+    public:
+        void run(int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                Warning() << "flood";
+            }
+        }
+    };
+}
+
+TEST(ALogger, CallSiteRateLimits)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    CurrentLogger::setCurrentLogger(logger);
+
+    Flood::Loop loop;
+
+    Logger::RateLimit sampling;
+    sampling.sampleEvery = 10;
+
+    Logger::Categories::setRateLimit("Flood", sampling);
+    loop.run(100);
+
+    ASSERT_EQ(sink->lines.size(), 10);
+
+    Logger::RateLimit rate;
+    rate.messagesPerSecond = 0.001;
+    rate.burst = 5;
+
+    Logger::Categories::setRateLimit("Flood", rate);
+    loop.run(100);
+
+    // Summary interval is not passed yet
+    ASSERT_EQ(sink->lines.size(), 15);
+
+    // Summary is written by timer, without next message
+    Logger::Categories::setSuppressedSummaryInterval(std::chrono::milliseconds(0));
+
+    ASSERT_TRUE(sink->waitForLines(16));
+    ASSERT_EQ(sink->lines[15].find("Suppressed messages: main.cpp:"), 0);
+    ASSERT_NE(sink->lines[15].find(" - 185"), std::string::npos);
+
+    Logger::Categories::resetRateLimit("Flood");
+    loop.run(1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    Logger::Categories::setSuppressedSummaryInterval(std::chrono::seconds(10));
+
+    ASSERT_EQ(sink->lines.size(), 17);
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+static void checkRepeatsCollapsing(LoggerPtr logger)
+{
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{ERROR_CLASS}: %{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setRepeatsCollapsingEnabled(true);
+    logger->addSink(sink);
+
+    for (int run = 0; run < 2; ++run)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            ErrorL(logger) << "storm";
+        }
+
+        InfoL(logger) << "calm " << run;
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ErrorL(logger) << "storm";
+    }
+
+    // Fields are not lost
+    for (int i = 0; i < 2; ++i)
+    {
+        InfoL(logger) << Logger::kv("attempt", i) << "retry";
+    }
+
+    logger->waitForLogToBeWritten();
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({
+        "Error: storm",
+        "Error: last message repeated 4 times",
+        "Info: calm 0",
+        "Error: storm",
+        "Error: last message repeated 4 times",
+        "Info: calm 1",
+        "Error: storm",
+        "Error: last message repeated 2 times",
+        "Info: retry",
+        "Info: retry"
+    }));
+}
+
+TEST(ALogger, RepeatsCollapsing)
+{
+    checkRepeatsCollapsing(std::make_shared<Loggers::BasicLogger>());
+    checkRepeatsCollapsing(std::make_shared<Loggers::AsyncLogger>());
+}
+
+TEST(ALogger, AsyncSinkFormatsRepeatsOfWrappedSink)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{ERROR_CLASS}: %{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setRepeatsCollapsingEnabled(true);
+    logger->addSink(std::make_shared<Sinks::AsyncSink>(sink));
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ErrorL(logger) << "storm";
+    }
+
+    InfoL(logger) << "calm";
+
+    logger->waitForLogToBeWritten();
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({
+        "Error: storm",
+        "Error: last message repeated 2 times",
+        "Info: calm"
+    }));
+}
+
+TEST(ALogger, AsyncSinkQueueIsBounded)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    // Logger waits for slow sink
+    auto blocked = std::make_shared<StalledSink>();
+    logger->addSink(std::make_shared<Sinks::AsyncSink>(blocked, 4));
+
+    std::atomic<int> pushed(0);
+
+    std::thread producer([logger, &pushed]()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            InfoL(logger) << i;
+            ++pushed;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Queue and message, that's being written
+    EXPECT_LE(pushed.load(), 5);
+
+    blocked->stalled = false;
+    producer.join();
+
+    logger->waitForLogToBeWritten();
+
+    ASSERT_EQ(blocked->written.load(), 100);
+
+    logger->removeSink(logger->sinks().back());
+
+    // Messages are dropped for slow sink
+    auto dropping = std::make_shared<StalledSink>();
+    auto async = std::make_shared<Sinks::AsyncSink>(dropping, 4, Sinks::AsyncSink::Overflow::Drop);
+    logger->addSink(async);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        InfoL(logger) << i;
+    }
+
+    ASSERT_GE(async->droppedMessages(), 95);
+
+    dropping->stalled = false;
+    logger->waitForLogToBeWritten();
+
+    ASSERT_EQ(dropping->written.load() + async->droppedMessages(), 100);
+}
+
+TEST(ALogger, RepeatsAreWrittenAfterIdleWindow)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setRepeatsCollapsingEnabled(true);
+    sink->setRepeatsWindow(std::chrono::milliseconds(50));
+    logger->addSink(sink);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ErrorL(logger) << "storm";
+    }
+
+    // Logger stays idle, repeats line is written by timer
+    ASSERT_TRUE(sink->waitForLines(2));
+    ASSERT_EQ(sink->lines[1], "last message repeated 2 times");
+}
+
+namespace Recorder
+{
+    class Worker
+    {
+    public:
+        void step(int index)
+        {
+            Debug() << "step " << index;
+        }
+
+        void fail()
+        {
+            Error() << "failed";
+        }
+    };
+}
+
+TEST(ALogger, FlightRecorderWritesHistoryOnError)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    CurrentLogger::setCurrentLogger(logger);
+
+    Logger::FlightRecorder::setEnabled(true);
+    Logger::Categories::setLevel("Recorder", AbstractLogger::ErrorClass::Info);
+
+    Recorder::Worker worker;
+
+    // Dropped by call site category level
+    worker.step(0);
+    worker.step(1);
+
+    // Dropped by sink level
+    DebugL(logger) << "direct";
+
+    InfoL(logger) << "visible";
+
+    worker.fail();
+    worker.fail();
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({
+        "visible",
+        "Flight recorder history, 3 messages",
+        "step 0",
+        "step 1",
+        "direct",
+        "failed",
+        "failed"
+    }));
+
+    Logger::FlightRecorder::setEnabled(false);
+    Logger::Categories::resetLevel("Recorder");
+
+    worker.step(2);
+    logger->triggerFlightRecorder();
+
+    ASSERT_EQ(sink->lines.size(), 7);
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+TEST(ALogger, SharedMemorySinkSurvivesProcessDeath)
+{
+    const std::string name = "/alogger_test_" + std::to_string(getpid());
+
+    Sinks::SharedMemorySink::remove(name);
+
+    auto child = fork();
+
+    ASSERT_NE(child, -1);
+
+    if (child == 0)
+    {
+        auto logger = std::make_shared<Loggers::BasicLogger>();
+        logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+        logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+        logger->setFormat("%{MESSAGE}");
+
+        // Small ring, so records are overwritten
+        logger->addSink(std::make_shared<Sinks::SharedMemorySink>(name, 4096));
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            InfoL(logger) << "record " << i;
+        }
+
+        // Nothing is cleaned up
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+
+    Sinks::SharedMemoryReader reader(name);
+
+    ASSERT_FALSE(reader.isWriterAlive());
+
+    std::vector<Sinks::SharedMemoryReader::Record> records;
+    reader.read(records);
+
+    ASSERT_GT(records.size(), 50);
+    ASSERT_LT(records.size(), 1000);
+
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        auto index = 1000 - records.size() + i;
+
+        ASSERT_EQ(records[i].sequence, index + 1);
+        ASSERT_EQ(records[i].text, "record " + std::to_string(index));
+        ASSERT_EQ(records[i].errorClass, AbstractLogger::ErrorClass::Info);
+    }
+
+    // Next process continues sequence
+    {
+        AbstractLogger::Message message;
+        message.errorClass = AbstractLogger::ErrorClass::Warning;
+
+        Sinks::SharedMemorySink sink(name, 4096);
+        sink.write(message, "next");
+    }
+
+    reader.read(records);
+
+    ASSERT_EQ(records.size(), 1);
+    ASSERT_EQ(records[0].sequence, 1001);
+    ASSERT_EQ(records[0].text, "next");
+    ASSERT_EQ(reader.droppedRecords(), 0);
+
+    Sinks::SharedMemorySink::remove(name);
+}
+
+TEST(ALogger, CollectorWritesRecordsOfSeveralLoggers)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_collector";
+
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path / "fallback");
+
+    auto socketPath = (path / "collector.sock").string();
+
+    auto createLogger = [&socketPath](Sinks::SinkPtr fallback)
+    {
+        auto logger = std::make_shared<Loggers::BasicLogger>();
+        logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+        logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+        logger->setFormat("%{MESSAGE}");
+        logger->addSink(std::make_shared<Sinks::CollectorSink>(socketPath, std::move(fallback)));
+
+        return logger;
+    };
+
+    // There is no collector yet
+    {
+        auto fallback = std::make_shared<Sinks::AppendFileSink>();
+        fallback->setLogPath((path / "fallback").string());
+
+        auto logger = createLogger(fallback);
+
+        InfoL(logger) << "without collector";
+        logger->waitForLogToBeWritten();
+    }
+
+    ASSERT_EQ(SystemTools::getFileContent((path / "fallback" / "log.txt").string()), "without collector\n");
+
+    auto sink = std::make_shared<MemorySink>();
+    Logger::Collector collector(socketPath, sink);
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        threads.emplace_back(
+            [&createLogger, i]()
+            {
+                auto logger = createLogger(nullptr);
+
+                for (int j = 0; j < 100; ++j)
+                {
+                    InfoL(logger) << i << " " << j;
+                }
+            }
+        );
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < 500 && collector.receivedRecords() < 200; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(collector.receivedRecords(), 200);
+
+    int next[2] = {0, 0};
+
+    for (auto&& line : sink->lines)
+    {
+        auto source = line[0] - '0';
+
+        ASSERT_EQ(line, std::to_string(source) + " " + std::to_string(next[source]));
+
+        ++next[source];
+    }
+}
+
+TEST(ALogger, KeyValueFieldsAndJsonLines)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE} [%{FIELDS}]");
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    auto jsonSink = std::make_shared<MemorySink>();
+    jsonSink->setFormatter(std::make_shared<Formatters::JsonLinesFormatter>());
+    logger->addSink(jsonSink);
+
+    InfoL(logger) << Logger::kv("user", 42)
+                  << Logger::kv("name", "bob")
+                  << Logger::kv("ratio", 0.5)
+                  << Logger::kv("ok", true)
+                  << Logger::kv("offset", -3)
+                  << "login \"quoted\"\n";
+
+    InfoL(logger) << "plain";
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({
+        "login \"quoted\"\n [user=42 name=bob ratio=0.5 ok=true offset=-3]",
+        "plain []"
+    }));
+
+    ASSERT_EQ(jsonSink->lines.size(), 2);
+
+    auto& json = jsonSink->lines[0];
+
+    ASSERT_EQ(json.rfind("{\"time\":\"", 0), 0);
+    ASSERT_NE(json.find("\"level\":\"Info\""), std::string::npos);
+    ASSERT_NE(json.find("\"message\":\"login \\\"quoted\\\"\\n\""), std::string::npos);
+    ASSERT_NE(json.find("\"fields\":{\"user\":42,\"name\":\"bob\",\"ratio\":0.5,\"ok\":true,\"offset\":-3}}"), std::string::npos);
+
+    ASSERT_EQ(jsonSink->lines[1].find("fields"), std::string::npos);
+
+    // Fields are written as text to other streams
+    std::ostringstream ss;
+    ss << Logger::kv("id", 7u);
+
+    ASSERT_EQ(ss.str(), "id=7");
+}
+
+static void checkSanitizer()
+{
+    using Formatters::Sanitizer;
+
+    // Special symbol at every position of SIMD blocks
+    for (std::size_t position = 0; position < 100; ++position)
+    {
+        std::string text(100, 'a');
+        text[position] = '\x1b';
+
+        ASSERT_EQ(Sanitizer::findSpecial(text, Sanitizer::Mode::Text), position);
+
+        text[position] = '"';
+
+        ASSERT_EQ(Sanitizer::findSpecial(text, Sanitizer::Mode::Text), 100);
+        ASSERT_EQ(Sanitizer::findSpecial(text, Sanitizer::Mode::Json), position);
+    }
+
+    std::string clean(40, 'x');
+    std::string text = clean + "\n\x1b[31m\"red\"\t\xd0\xbf\xd1\x80\xff\xc0\xaf\xe2\x82";
+
+    std::string result;
+    Sanitizer::append(result, text, Sanitizer::Mode::Text);
+
+    ASSERT_EQ(result, clean + "\\n\\x1b[31m\"red\"\t\xd0\xbf\xd1\x80\\xff\\xc0\\xaf\\xe2\\x82");
+
+    result.clear();
+    Sanitizer::append(result, text, Sanitizer::Mode::Json);
+
+    ASSERT_EQ(result, clean + "\\n\\u001b[31m\\\"red\\\"\\t\xd0\xbf\xd1\x80\\ufffd\\ufffd\\ufffd\\ufffd\\ufffd");
+}
+
+static std::string sanitize(const std::string& text, bool simd, Formatters::Sanitizer::Mode mode)
+{
+    Formatters::Sanitizer::setSimdEnabled(simd);
+
+    std::string result;
+    Formatters::Sanitizer::append(result, text, mode);
+
+    Formatters::Sanitizer::setSimdEnabled(true);
+
+    return result;
+}
+
+TEST(ALogger, SanitizerSimdMatchesScalarOnUtf8)
+{
+    using Formatters::Sanitizer;
+
+    // Valid sequences, broken sequences and ASCII
+    const char* pieces[] = {
+        "a", "abcdefgh", "\n", "\"", "\\", "\x7f",
+        "\xd0\xbf", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xf4\x8f\xbf\xbf",
+        "\xff", "\xc0\xaf", "\xe0\x80\x80", "\xed\xa0\x80", "\xf4\x90\x80\x80",
+        "\xe2\x82", "\xbf", "\xf0\x9f\x98"
+    };
+
+    const std::size_t validPieces = 10;
+
+    std::mt19937 random(42);
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string text;
+        auto length = random() % 160;
+        auto broken = i % 2 == 0;
+
+        while (text.size() < length)
+        {
+            text += pieces[random() % (broken ? std::size(pieces) : validPieces)];
+        }
+
+        // Sequences are cut at the end too
+        text.resize(length);
+
+        for (auto mode : {Sanitizer::Mode::Text, Sanitizer::Mode::Json})
+        {
+            ASSERT_EQ(sanitize(text, true, mode), sanitize(text, false, mode)) << i;
+        }
+    }
+
+    // Kernel with UTF-8 validation skips valid text
+    std::string text;
+
+    while (text.size() < 100)
+    {
+        text += "\xd0\xbf\xd1\x80\xe2\x82\xac\xf0\x9f\x98\x80 ";
+    }
+
+    if (std::string(Sanitizer::kernelName()) == "avx2")
+    {
+        ASSERT_EQ(Sanitizer::findSpecial(text, Sanitizer::Mode::Json), text.size());
+    }
+
+    ASSERT_EQ(sanitize(text, true, Sanitizer::Mode::Json), text);
+}
+
+TEST(ALogger, SanitizerEscapesControlsAndInvalidUtf8)
+{
+    checkSanitizer();
+
+    Formatters::Sanitizer::setSimdEnabled(false);
+    ASSERT_STREQ(Formatters::Sanitizer::kernelName(), "scalar");
+
+    checkSanitizer();
+
+    Formatters::Sanitizer::setSimdEnabled(true);
+
+    AbstractLogger::Message message;
+    message.errorClass = AbstractLogger::ErrorClass::Info;
+    message.message = "one\ntwo";
+
+    ASSERT_EQ(Formatters::PatternFormatter("%{MESSAGE}").format(message), "one\ntwo");
+    ASSERT_EQ(Formatters::PatternFormatter("%{MESSAGE}", true).format(message), "one\\ntwo");
+}
+
+class TimeSink : public Sinks::AbstractSink
+{
+public:
+    std::vector<AbstractLogger::Message> messages;
+
+protected:
+    void onWrite(const AbstractLogger::Message& message, const std::string&) override
+    {
+        messages.push_back(message);
+    }
+};
+
+TEST(ALogger, ClockSourcesConvertToWallTime)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    auto sink = std::make_shared<TimeSink>();
+    logger->addSink(sink);
+
+    for (auto source : {Logger::Clock::Source::System,
+                        Logger::Clock::Source::Coarse,
+                        Logger::Clock::Source::Tsc})
+    {
+        if (!Logger::Clock::isAvailable(source))
+        {
+            ASSERT_THROW(Logger::Clock::setSource(source), std::runtime_error);
+            continue;
+        }
+
+        Logger::Clock::setSource(source);
+
+        auto before = std::chrono::system_clock::now();
+
+        InfoL(logger) << "timed";
+
+        auto after = std::chrono::system_clock::now();
+
+        // Coarse clock is updated every few milliseconds
+        auto time = sink->messages.back().time();
+
+        ASSERT_NE(sink->messages.back().timestamp, 0);
+        ASSERT_GE(time, before - std::chrono::milliseconds(20));
+        ASSERT_LE(time, after + std::chrono::milliseconds(20));
+    }
+
+    // Timestamp of previous source is still valid
+    auto tscTimestamp = sink->messages.back().timestamp;
+
+    Logger::Clock::setSource(Logger::Clock::Source::System);
+
+    ASSERT_LT(
+        std::chrono::system_clock::now() - Logger::Clock::toTimePoint(tscTimestamp),
+        std::chrono::seconds(1)
+    );
+}
+
+TEST(ALogger, NamedThreadsAreRendered)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{THREAD_NAME} %{THREAD}");
+
+    auto sink = std::make_shared<MemorySink>();
+    logger->addSink(sink);
+
+    auto jsonSink = std::make_shared<MemorySink>();
+    jsonSink->setFormatter(std::make_shared<Formatters::JsonLinesFormatter>());
+    logger->addSink(jsonSink);
+
+    std::thread::id id;
+
+    std::thread worker(
+        [&logger, &id]()
+        {
+            id = std::this_thread::get_id();
+
+            InfoL(logger) << "unnamed";
+
+            Logger::Threads::setName("worker-12");
+
+            InfoL(logger) << "named";
+        }
+    );
+
+    worker.join();
+
+    std::ostringstream ss;
+    ss << "0x" << std::setfill('0') << std::setw(16) << std::hex << id;
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({
+        ss.str() + " " + ss.str(),
+        "worker-12 " + ss.str()
+    }));
+
+    ASSERT_EQ(jsonSink->lines[0].find("thread_name"), std::string::npos);
+    ASSERT_NE(jsonSink->lines[1].find("\"thread\":\"" + ss.str() + "\",\"thread_name\":\"worker-12\""), std::string::npos);
+
+    // Name is removed on thread exit
+    ASSERT_EQ(Logger::Threads::name(id), "");
+}
+
+TEST(ALogger, RecordQueuePacksMessages)
+{
+    Logger::RecordQueue queue(16);
+
+    AbstractLogger::Message message;
+    message.timestamp = Logger::Clock::now();
+    message.errorClass = AbstractLogger::ErrorClass::Warning;
+    message.thread = std::this_thread::get_id();
+    message.filename = "main.cpp";
+    message.line = 42;
+    message.context = "Class::method";
+    message.fields = {
+        Logger::makeField("user", 42),
+        Logger::makeField("name", "bob"),
+        Logger::makeField("ok", true)
+    };
+
+    AbstractLogger::Message result;
+    uint64_t position = 0;
+    uint64_t blocks = 0;
+    uint64_t expected = 0;
+
+    // Messages of different sizes wrap around ring
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        message.message = std::string(i * 3, static_cast<char>('a' + i % 26));
+
+        ASSERT_TRUE(queue.tryPush(message));
+        ASSERT_TRUE(queue.tryPop(result, position, blocks));
+        ASSERT_TRUE(queue.empty());
+
+        ASSERT_EQ(position, expected);
+        ASSERT_EQ(blocks, Logger::RecordQueue::blocksCount(message));
+        expected += blocks;
+
+        ASSERT_EQ(result.timestamp, message.timestamp);
+        ASSERT_EQ(result.errorClass, message.errorClass);
+        ASSERT_EQ(result.thread, message.thread);
+        ASSERT_EQ(result.filename, message.filename);
+        ASSERT_EQ(result.line, message.line);
+        ASSERT_EQ(result.context, message.context);
+        ASSERT_EQ(result.message, message.message);
+        ASSERT_EQ(result.fields.size(), 3);
+        ASSERT_EQ(result.fields[0].intValue, 42);
+        ASSERT_EQ(result.fields[1].string, "bob");
+        ASSERT_TRUE(result.fields[2].boolValue);
+    }
+
+    // Span keeps flag and duration
+    message.span = true;
+    message.spanDuration = 123456789;
+
+    ASSERT_TRUE(queue.tryPush(message));
+    ASSERT_TRUE(queue.tryPop(result, position, blocks));
+    ASSERT_EQ(blocks, Logger::RecordQueue::blocksCount(message));
+    ASSERT_TRUE(result.span);
+    ASSERT_EQ(result.spanDuration, 123456789u);
+    ASSERT_EQ(result.fields.size(), 3);
+
+    message.span = false;
+
+    ASSERT_TRUE(queue.tryPush(message));
+    ASSERT_TRUE(queue.tryPop(result, position, blocks));
+    ASSERT_FALSE(result.span);
+
+    // Full queue does not accept message
+    message.fields.clear();
+    message.message = "short";
+
+    std::size_t pushed = 0;
+
+    while (queue.tryPush(message))
+    {
+        ++pushed;
+    }
+
+    ASSERT_EQ(pushed, 16 / Logger::RecordQueue::blocksCount(message));
+
+    while (queue.tryPop(result, position, blocks))
+    {
+    }
+
+    // Message, that's bigger than queue, is truncated
+    message.message = std::string(4096, 'x');
+
+    ASSERT_TRUE(queue.tryPush(message));
+    ASSERT_TRUE(queue.tryPop(result, position, blocks));
+    ASSERT_EQ(blocks, 16);
+    ASSERT_EQ(result.context, message.context);
+    ASSERT_EQ(result.message, std::string(16 * Logger::RecordQueue::BlockDataSize - sizeof(Logger::RecordQueue::Header) - message.context.size(), 'x'));
+}
+
+TEST(ALogger, StaticLoggerWritesToSinkPolicies)
+{
+    Loggers::StaticLogger<Loggers::DirectQueue, Formatters::PatternFormatter, MemorySink> direct(
+        "%{ERROR_CLASS}: %{CONTEXT}: %{MESSAGE}"
+    );
+
+    direct.sink<0>().setMinimumErrorClass(AbstractLogger::ErrorClass::Info);
+
+    direct.log(AbstractLogger::ErrorClass::Debug, __FILENAME__, __LINE__, std::this_thread::get_id(), "Class", "method", "hidden");
+    direct.log(AbstractLogger::ErrorClass::Info, __FILENAME__, __LINE__, std::this_thread::get_id(), "Class", "method", "shown");
+    direct.log(AbstractLogger::ErrorClass::Error, __FILENAME__, __LINE__, std::this_thread::get_id(), "", "function", "error");
+
+    ASSERT_EQ(direct.sink<0>().lines, std::vector<std::string>({
+        "Info: Class::method: shown",
+        "Error: function: error"
+    }));
+
+    // Async logger is used through adapter with logger stream
+    using AsyncStaticLogger = Loggers::StaticLogger<
+        Loggers::AsyncQueue,
+        Formatters::JsonLinesFormatter,
+        MemorySink,
+        MemorySink
+    >;
+
+    auto logger = std::make_shared<Loggers::StaticLoggerAdapter<AsyncStaticLogger>>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+
+    logger->logger().sink<1>().setMinimumErrorClass(AbstractLogger::ErrorClass::Warning);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        InfoL(logger) << "message " << i;
+    }
+
+    WarningL(logger) << "warning";
+
+    logger->waitForLogToBeWritten();
+
+    auto& all = logger->logger().sink<0>().lines;
+    auto& warnings = logger->logger().sink<1>().lines;
+
+    ASSERT_EQ(all.size(), 1001);
+    ASSERT_NE(all[999].find("\"message\":\"message 999\""), std::string::npos);
+    ASSERT_EQ(warnings.size(), 1);
+    ASSERT_NE(warnings[0].find("\"level\":\"Warning\""), std::string::npos);
+}
+
+static std::shared_ptr<Loggers::BasicLogger> makeMemoryLogger(std::shared_ptr<MemorySink> sink)
+{
+    auto logger = std::make_shared<Loggers::BasicLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+    logger->addSink(std::move(sink));
+
+    return logger;
+}
+
+TEST(ALogger, CurrentLoggerIsReplacedSafely)
+{
+    // Message without logger is dropped
+    CurrentLogger::setCurrentLogger(nullptr);
+
+    ASSERT_NO_THROW(InfoEx("Test") << "dropped");
+    ASSERT_THROW(CurrentLogger::i(), std::runtime_error);
+
+    auto sink = std::make_shared<MemorySink>();
+    auto logger = makeMemoryLogger(sink);
+
+    std::weak_ptr<AbstractLogger> weak = logger;
+
+    CurrentLogger::setCurrentLogger(std::move(logger));
+
+    // Logger, that's replaced while message is formed,
+    // is kept until message is posted and released
+    // by last unpin
+    InfoEx("Test") << "first" << (CurrentLogger::setCurrentLogger(nullptr), "");
+
+    ASSERT_TRUE(weak.expired());
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"first"}));
+
+    // Logger is replaced while other threads are logging
+    std::atomic_bool running(true);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&running]()
+            {
+                while (running)
+                {
+                    InfoEx("Test") << "message";
+                }
+            }
+        );
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        CurrentLogger::setCurrentLogger(makeMemoryLogger(std::make_shared<MemorySink>()));
+    }
+
+    running = false;
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+TEST(ALogger, CurrentLoggerReferenceDoesNotBlockWriters)
+{
+    auto sink = std::make_shared<MemorySink>();
+    auto logger = makeMemoryLogger(sink);
+
+    std::weak_ptr<AbstractLogger> weak = logger;
+
+    CurrentLogger::setCurrentLogger(std::move(logger));
+
+    std::promise<void> entered;
+    std::promise<void> changed;
+
+    auto operand = [&entered, &changed]()
+    {
+        entered.set_value();
+        changed.get_future().wait();
+
+        return "operand";
+    };
+
+    std::thread thread(
+        [&operand]()
+        {
+            InfoEx("Pin") << operand();
+        }
+    );
+
+    entered.get_future().wait();
+
+    // Epoch writers don't wait for message operands,
+    // replaced logger is kept by pin
+    Logger::Categories::setLevel("Pin", AbstractLogger::ErrorClass::Info);
+    CurrentLogger::setCurrentLogger(nullptr);
+
+    ASSERT_FALSE(weak.expired());
+
+    changed.set_value();
+    thread.join();
+
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"operand"}));
+
+    // Released without next logger change
+    ASSERT_TRUE(weak.expired());
+
+    Logger::Categories::resetLevel("Pin");
+}
+
+TEST(ALogger, DisabledMessageOperandsAreNotEvaluated)
+{
+    auto sink = std::make_shared<MemorySink>();
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+
+    CurrentLogger::setCurrentLogger(makeMemoryLogger(sink));
+    Logger::Categories::setLevel("Lazy", AbstractLogger::ErrorClass::Info);
+
+    int evaluated = 0;
+
+    auto expensive = [&evaluated]()
+    {
+        ++evaluated;
+        return "expensive";
+    };
+
+    DebugEx("Lazy") << expensive();
+    InfoEx("Lazy") << expensive();
+
+    ASSERT_EQ(evaluated, 1);
+
+    // Macro is single expression, so `else`
+    // belongs to outer `if`
+    for (bool condition : {true, false})
+    {
+        if (condition)
+            DebugEx("Lazy") << expensive();
+        else
+            WarningEx("Lazy") << "else";
+    }
+
+    ASSERT_EQ(evaluated, 1);
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"expensive", "else"}));
+
+    // Class name is evaluated once, cached
+    // category is changed with class name
+    int classnames = 0;
+
+    for (auto category : {"Lazy", "Other", "Lazy"})
+    {
+        DebugEx((++classnames, category)) << category;
+    }
+
+    ASSERT_EQ(classnames, 3);
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"expensive", "else", "Other"}));
+
+    Logger::Categories::resetLevel("Lazy");
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+namespace Lazy
+{
+    class Worker
+    {
+    public:
+        template<typename Operand>
+        void run(Operand&& operand)
+        {
+            Debug() << operand();
+            Info() << operand();
+        }
+    };
+}
+
+TEST(ALogger, OperandsBelowLoggerLevelAreNotEvaluated)
+{
+    // Sink has default `Info` level
+    auto sink = std::make_shared<MemorySink>();
+
+    CurrentLogger::setCurrentLogger(makeMemoryLogger(sink));
+
+    int evaluated = 0;
+
+    auto expensive = [&evaluated]()
+    {
+        ++evaluated;
+        return "expensive";
+    };
+
+    DebugF() << expensive();
+    InfoF() << expensive();
+
+    ASSERT_EQ(evaluated, 1);
+
+    Lazy::Worker worker;
+    worker.run(expensive);
+
+    ASSERT_EQ(evaluated, 2);
+
+    // Sink level change refreshes call sites
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+
+    worker.run(expensive);
+
+    ASSERT_EQ(evaluated, 4);
+    ASSERT_EQ(sink->lines, std::vector<std::string>({"expensive", "expensive", "expensive", "expensive"}));
+
+    CurrentLogger::setCurrentLogger(nullptr);
+}
+
+__attribute__((noinline)) void failingOperation(const LoggerPtr& logger)
+{
+    ErrorL(logger) << "failed";
+}
+
+TEST(ALogger, ErrorsHaveSymbolizedBacktrace)
+{
+    Logger::Backtrace::setLevel(AbstractLogger::ErrorClass::Error);
+
+    auto logger = std::make_shared<Loggers::AsyncLogger>();
+    logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+    logger->setFormat("%{MESSAGE}");
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+    logger->addSink(sink);
+
+    LoggerPtr base = logger;
+
+    InfoL(base) << "info";
+
+    std::size_t cached = 0;
+
+    // Same addresses are taken from cache
+    for (int i = 0; i < 2; ++i)
+    {
+        failingOperation(base);
+
+        logger->waitForLogToBeWritten();
+
+        if (i == 0)
+        {
+            cached = Logger::Backtrace::cacheSize();
+        }
+    }
+
+    Logger::Backtrace::setLevel(AbstractLogger::ErrorClass::None);
+
+    ASSERT_EQ(sink->lines.size(), 3u);
+    ASSERT_EQ(sink->lines[0], "info");
+    ASSERT_EQ(sink->lines[1].rfind("failed\n    #0 ", 0), 0);
+    ASSERT_NE(sink->lines[1].find("failingOperation"), std::string::npos);
+    ASSERT_EQ(sink->lines[1], sink->lines[2]);
+    ASSERT_EQ(Logger::Backtrace::cacheSize(), cached);
+}
+
+TEST(ALogger, TraceSpansAreWrittenAsChromeTrace)
+{
+    auto path = std::filesystem::temp_directory_path() / "alogger_trace.json";
+
+    auto sink = std::make_shared<MemorySink>();
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Warning);
+
+    auto debugSink = std::make_shared<MemorySink>();
+    debugSink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+
+    {
+        auto logger = makeMemoryLogger(sink);
+        logger->addSink(std::make_shared<Sinks::ChromeTraceSink>(path.string()));
+
+        // Trace sink doesn't make debug messages accepted
+        ASSERT_EQ(logger->minimumAcceptedErrorClass(), AbstractLogger::ErrorClass::Warning);
+
+        logger->addSink(debugSink);
+
+        CurrentLogger::setCurrentLogger(logger);
+        Logger::TraceSpan::setEnabled(true);
+        Logger::Threads::setName("tracer");
+
+        {
+            LogScope("fast", std::chrono::milliseconds(1000));
+        }
+
+        {
+            LogScope("slow \"query\"", std::chrono::milliseconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        Logger::TraceSpan::setEnabled(false);
+
+        // Disabled span only checks threshold
+        {
+            LogScope("disabled");
+        }
+
+        Logger::Threads::setName(std::string());
+        CurrentLogger::setCurrentLogger(nullptr);
+    }
+
+    auto trace = SystemTools::getFileContent(path.string());
+
+    ASSERT_EQ(sink->lines.size(), 1u);
+    ASSERT_EQ(sink->lines[0].rfind("Span \"slow \"query\"\" took ", 0), 0);
+    ASSERT_NE(sink->lines[0].find("threshold 1 ms"), std::string::npos);
+
+    // Spans are written only by trace sinks
+    ASSERT_EQ(debugSink->lines, sink->lines);
+
+    ASSERT_EQ(trace.rfind("[\n{\"name\":\"thread_name\",\"ph\":\"M\"", 0), 0);
+    ASSERT_NE(trace.find("\"args\":{\"name\":\"tracer\"}"), std::string::npos);
+    ASSERT_NE(trace.find("{\"name\":\"fast\",\"cat\":\"TestBody\",\"ph\":\"X\",\"ts\":"), std::string::npos);
+    ASSERT_NE(trace.find("{\"name\":\"slow \\\"query\\\"\",\"cat\":\"TestBody\",\"ph\":\"X\""), std::string::npos);
+    ASSERT_NE(trace.find("\"ph\":\"i\""), std::string::npos);
+    ASSERT_EQ(trace.find("disabled"), std::string::npos);
+    ASSERT_EQ(trace.substr(trace.size() - 3), "\n]\n");
+
+    std::filesystem::remove(path);
+}
+
+class BlockingSink : public Sinks::AbstractSink
+{
+protected:
+    void onWrite(const AbstractLogger::Message&, const std::string&) override
+    {
+        std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+};
+
+TEST(ALoggerDeathTest, CrashHandlerFlushesQueue)
+{
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+    auto path = std::filesystem::temp_directory_path() / "alogger_crash_handler";
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+
+    ASSERT_DEATH(
+        {
+            auto logger = std::make_shared<Loggers::AsyncLogger>();
+            logger->setLogPath(path.string());
+            logger->setFormat("%{MESSAGE}");
+            logger->setMinimumTerminalOutputErrorClass(AbstractLogger::ErrorClass::None);
+            logger->setMinimumFileOutputErrorClass(AbstractLogger::ErrorClass::None);
+            logger->addSink(std::make_shared<BlockingSink>());
+
+            // Handler converts TSC with calibration copy
+            if (Logger::Clock::isAvailable(Logger::Clock::Source::Tsc))
+            {
+                Logger::Clock::setSource(Logger::Clock::Source::Tsc);
+            }
+
+            logger->setCrashHandlerEnabled(true);
+
+            for (int i = 0; i < 10; ++i)
+            {
+                InfoL(logger) << "queued " << i;
+            }
+
+            std::abort();
+        },
+        "queued 9\n--- ALogger: [0-9]+ queued messages flushed on signal 6 ---"
+    );
+
+    auto content = SystemTools::getFileContent((path / "log.txt").string());
+
+    ASSERT_NE(content.find("Info: queued 9\n--- ALogger: "), std::string::npos);
+
+    auto line = content.rfind('\n', content.find("Info: queued 9"));
+    auto seconds = std::stoll(content.substr(line == std::string::npos ? 0 : line + 1));
+
+    ASSERT_LT(std::abs(seconds - static_cast<long long>(std::time(nullptr))), 60);
+
+    std::filesystem::remove_all(path);
 }
 
 int main(int argc, char** argv)
@@ -0,0 +1,54 @@
+#include <Collector.hpp>
+#include <Sinks/FileSink.hpp>
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * @brief Tool, that collects logs of local
+ * processes, that use `Sinks::CollectorSink`,
+ * into one rolling log directory.
+ *
+ * Usage: alogger-collector <socket> <log directory> [maximum file size]
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <socket> <log directory> [maximum file size]" << std::endl;
+        return 1;
+    }
+
+    auto sink = std::make_shared<Sinks::FileSink>();
+    sink->setLogPath(argv[2]);
+    sink->setMinimumErrorClass(AbstractLogger::ErrorClass::Debug);
+
+    if (argc > 3)
+    {
+        sink->setMaximumLogFile(std::stoull(argv[3]));
+    }
+
+    // Signals are received synchronously
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try
+    {
+        Logger::Collector collector(argv[1], sink);
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+
+        std::cerr << collector.receivedRecords() << " records collected" << std::endl;
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
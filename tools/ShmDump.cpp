@@ -0,0 +1,90 @@
+#include <Sinks/SharedMemorySink.hpp>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <stdexcept>
+
+/**
+ * @brief Tool for reading shared memory ring of
+ * `Sinks::SharedMemorySink`. Works with live process
+ * or after process death.
+ *
+ * Usage: alogger-shmdump <name> [--follow] [--remove]
+ *   --follow - wait for new records while writer is alive.
+ *   --remove - remove shared memory object after reading.
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <name> [--follow] [--remove]" << std::endl;
+        return 1;
+    }
+
+    std::string name = argv[1];
+    bool follow = false;
+    bool remove = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--follow") == 0)
+        {
+            follow = true;
+        }
+        else if (std::strcmp(argv[i], "--remove") == 0)
+        {
+            remove = true;
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    try
+    {
+        Sinks::SharedMemoryReader reader(name);
+
+        std::vector<Sinks::SharedMemoryReader::Record> records;
+
+        while (true)
+        {
+            reader.read(records);
+
+            for (auto&& record : records)
+            {
+                std::cout << record.text << '\n';
+            }
+
+            std::cout.flush();
+
+            if (!follow || (records.empty() && !reader.isWriterAlive()))
+            {
+                break;
+            }
+
+            if (records.empty())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+
+        if (reader.droppedRecords() != 0)
+        {
+            std::cerr << reader.droppedRecords() << " records were overwritten while reading" << std::endl;
+        }
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (remove)
+    {
+        Sinks::SharedMemorySink::remove(name);
+    }
+
+    return 0;
+}